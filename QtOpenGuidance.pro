@@ -50,6 +50,9 @@ SOURCES += \
     src/3d/BufferMeshGeometry.cpp \
     src/3d/CultivatedAreaMesh.cpp \
     src/3d/CultivatedAreaMeshGeometry.cpp \
+    src/3d/GridMaterial.cpp \
+    src/3d/InstancedMarkerMaterial.cpp \
+    src/3d/InstancedMarkerMesh.cpp \
     src/3d/texturerendertarget.cpp \
     src/block/ActionDockBlock.cpp \
     src/block/CultivatedAreaModel.cpp \
@@ -80,6 +83,12 @@ SOURCES += \
     src/gui/ValueDock.cpp \
     src/gui/XteDock.cpp \
     src/kinematic/CgalWorker.cpp \
+    src/kinematic/CoverageMap.cpp \
+    src/kinematic/FieldBenchmark.cpp \
+    src/kinematic/FieldBinary.cpp \
+    src/kinematic/FieldGeoJson.cpp \
+    src/kinematic/FieldLibrary.cpp \
+    src/kinematic/GeographicConvertionWrapper.cpp \
     src/kinematic/PathPrimitive.cpp \
     src/kinematic/PathPrimitiveLine.cpp \
     src/kinematic/PathPrimitiveRay.cpp \
@@ -94,6 +103,7 @@ SOURCES += \
     src/gui/CameraToolbar.cpp \
     src/gui/GuidanceToolbar.cpp \
     src/gui/GuidanceTurning.cpp \
+    src/gui/HeadlessRunner.cpp \
     src/gui/ImplementBlockModel.cpp \
     src/gui/ImplementSectionModel.cpp \
     src/gui/NumberBlockModel.cpp \
@@ -108,6 +118,9 @@ HEADERS += \
     src/3d/BufferMeshGeometry.h \
     src/3d/CultivatedAreaMesh.h \
     src/3d/CultivatedAreaMeshGeometry.h \
+    src/3d/GridMaterial.h \
+    src/3d/InstancedMarkerMaterial.h \
+    src/3d/InstancedMarkerMesh.h \
     src/3d/texturerendertarget.h \
     src/block/AckermannSteering.h \
     src/block/ActionDockBlock.h \
@@ -121,6 +134,7 @@ HEADERS += \
     src/block/FieldManager.h \
     src/block/FileStream.h \
     src/block/FpsMeasurement.h \
+    src/block/FrameTiming.h \
     src/block/GlobalPlanner.h \
     src/block/GridModel.h \
     src/block/Implement.h \
@@ -164,6 +178,7 @@ HEADERS += \
     src/gui/GlobalPlannerToolbar.h \
     src/gui/GuidanceToolbar.h \
     src/gui/GuidanceTurning.h \
+    src/gui/HeadlessRunner.h \
     src/gui/ImplementBlockModel.h \
     src/gui/ImplementSectionModel.h \
     src/gui/MyFrameworkWidgetFactory.h \
@@ -183,7 +198,14 @@ HEADERS += \
     src/gui/ValueDock.h \
     src/gui/VectorBlockModel.h \
     src/gui/XteDock.h \
+    src/kinematic/BoundaryWalker.h \
     src/kinematic/CgalWorker.h \
+    src/kinematic/CoverageMap.h \
+    src/kinematic/FieldBenchmark.h \
+    src/kinematic/FieldBinary.h \
+    src/kinematic/FieldData.h \
+    src/kinematic/FieldGeoJson.h \
+    src/kinematic/FieldLibrary.h \
     src/kinematic/FixedKinematic.h \
     src/kinematic/GeographicConvertionWrapper.h \
     src/kinematic/PathPrimitive.h \
@@ -193,6 +215,7 @@ HEADERS += \
     src/kinematic/PathPrimitiveSequence.h \
     src/kinematic/Plan.h \
     src/kinematic/PlanGlobal.h \
+    src/kinematic/Pose.h \
     src/kinematic/PoseOptions.h \
     src/kinematic/TrailerKinematic.h
 
@@ -20,3 +20,6 @@
 #include "moc_BufferMeshGeometry.cpp"
 #include "moc_BufferMesh.cpp"
 #include "moc_CultivatedAreaMesh.cpp"
+#include "moc_GridMaterial.cpp"
+#include "moc_InstancedMarkerMaterial.cpp"
+#include "moc_InstancedMarkerMesh.cpp"
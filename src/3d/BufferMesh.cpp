@@ -46,3 +46,17 @@ void BufferMesh::bufferUpdate( const QVector<QVector3D>& pos ) {
   setVertexCount( m_bufferMeshGeo->vertexCount() );
   setGeometry( m_bufferMeshGeo );
 }
+
+void BufferMesh::bufferAppend( const QVector3D& pos ) {
+  m_bufferMeshGeo->appendPoints( &pos, 1 );
+
+  setVertexCount( m_bufferMeshGeo->vertexCount() );
+  setGeometry( m_bufferMeshGeo );
+}
+
+void BufferMesh::bufferAppend( const QVector<QVector3D>& pos ) {
+  m_bufferMeshGeo->appendPoints( pos.constData(), pos.size() );
+
+  setVertexCount( m_bufferMeshGeo->vertexCount() );
+  setGeometry( m_bufferMeshGeo );
+}
@@ -39,6 +39,10 @@ class BufferMesh : public Qt3DRender::QGeometryRenderer {
     ~BufferMesh();
     void bufferUpdate( const QVector<QVector3D>& pos );
 
+    // appends to the vertices of the last update, for meshes growing while recording
+    void bufferAppend( const QVector3D& pos );
+    void bufferAppend( const QVector<QVector3D>& pos );
+
   private:
     BufferMeshGeometry* m_bufferMeshGeo = nullptr;
 };
@@ -25,6 +25,8 @@
 #include <QVector3D>
 #include "BufferMeshGeometry.h"
 
+#include <algorithm>
+
 BufferMeshGeometry::BufferMeshGeometry( Qt3DCore::QNode* parent ) :
   Qt3DRender::QGeometry( parent )
   , m_positionAttribute( new Qt3DRender::QAttribute( this ) )
@@ -51,7 +53,7 @@ BufferMeshGeometry::~BufferMeshGeometry() {
 }
 
 int BufferMeshGeometry::vertexCount() {
-  return m_vertexBuffer->data().size() / static_cast<int>( sizeof( QVector3D ) );
+  return m_vertexCount;
 }
 
 void BufferMeshGeometry::updatePoints( const QVector<QVector3D>& vertices ) {
@@ -59,4 +61,32 @@ void BufferMeshGeometry::updatePoints( const QVector<QVector3D>& vertices ) {
   vertexBufferData.resize( vertices.size() * static_cast<int>( sizeof( QVector3D ) ) );
   memcpy( vertexBufferData.data(), vertices.constData(), static_cast<size_t>( vertexBufferData.size() ) );
   m_vertexBuffer->setData( vertexBufferData );
+
+  m_vertexCount = vertices.size();
+  m_vertexCapacity = vertices.size();
+}
+
+void BufferMeshGeometry::appendPoints( const QVector3D* vertices, int count ) {
+  if( count <= 0 ) {
+    return;
+  }
+
+  const int offset = m_vertexCount * static_cast<int>( sizeof( QVector3D ) );
+  const int size = count * static_cast<int>( sizeof( QVector3D ) );
+
+  if( ( m_vertexCount + count ) <= m_vertexCapacity ) {
+    // only the new range is sent to the backend
+    QByteArray vertexBufferData( reinterpret_cast<const char*>( vertices ), size );
+    m_vertexBuffer->updateData( offset, vertexBufferData );
+  } else {
+    // reallocate with the double size; the content after the vertices isn't drawn
+    m_vertexCapacity = std::max( { minVertexCapacity, m_vertexCapacity * 2, m_vertexCount + count } );
+
+    QByteArray vertexBufferData = m_vertexBuffer->data();
+    vertexBufferData.resize( m_vertexCapacity * static_cast<int>( sizeof( QVector3D ) ) );
+    memcpy( vertexBufferData.data() + offset, vertices, static_cast<size_t>( size ) );
+    m_vertexBuffer->setData( vertexBufferData );
+  }
+
+  m_vertexCount += count;
 }
@@ -37,7 +37,16 @@ class BufferMeshGeometry : public Qt3DRender::QGeometry {
 
     void updatePoints( const QVector<QVector3D>& vertices );
 
+    // only uploads the new vertices; the buffer grows geometrically, so appending is O(1) amortized
+    void appendPoints( const QVector3D* vertices, int count );
+
   private:
     Qt3DRender::QAttribute* m_positionAttribute;
     Qt3DRender::QBuffer* m_vertexBuffer;
+
+    // the buffer can be bigger than the vertices in it
+    int m_vertexCount = 0;
+    int m_vertexCapacity = 0;
+
+    static constexpr int minVertexCapacity = 1024;
 };
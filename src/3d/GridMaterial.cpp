@@ -0,0 +1,184 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "GridMaterial.h"
+
+#include <QStringList>
+
+#include <Qt3DRender/QEffect>
+#include <Qt3DRender/QTechnique>
+#include <Qt3DRender/QRenderPass>
+#include <Qt3DRender/QShaderProgram>
+#include <Qt3DRender/QFilterKey>
+#include <Qt3DRender/QParameter>
+#include <Qt3DRender/QGraphicsApiFilter>
+#include <Qt3DRender/QBlendEquation>
+#include <Qt3DRender/QBlendEquationArguments>
+#include <Qt3DRender/QNoDepthMask>
+
+namespace {
+  // the body of the shaders is the same for all versions, only the header differs: it maps "in", "out" and
+  // "fragColor" to the keywords of GLSL 1.10 / ES 1.00
+  const QByteArray vertexShader = QByteArrayLiteral(
+                                    "in vec3 vertexPosition;\n"
+                                    "out vec3 worldPosition;\n"
+                                    "uniform mat4 modelMatrix;\n"
+                                    "uniform mat4 mvp;\n"
+                                    "void main() {\n"
+                                    "  worldPosition = ( modelMatrix * vec4( vertexPosition, 1.0 ) ).xyz;\n"
+                                    "  gl_Position = mvp * vec4( vertexPosition, 1.0 );\n"
+                                    "}\n" );
+
+  // the lines are antialiased over one pixel with the derivatives of the coordinates
+  const QByteArray fragmentShader = QByteArrayLiteral(
+                                      "in vec3 worldPosition;\n"
+                                      "uniform vec3 eyePosition;\n"
+                                      "uniform vec2 gridStep;\n"
+                                      "uniform vec2 gridStepCoarse;\n"
+                                      "uniform float cameraThreshold;\n"
+                                      "uniform float cameraThresholdCoarse;\n"
+                                      "uniform vec4 color;\n"
+                                      "uniform vec4 colorCoarse;\n"
+                                      "float lines( vec2 stepOfLines ) {\n"
+                                      "  vec2 coordinate = worldPosition.xy / stepOfLines;\n"
+                                      "  vec2 distanceToLine = abs( fract( coordinate - 0.5 ) - 0.5 ) / fwidth( coordinate );\n"
+                                      "  return 1.0 - min( min( distanceToLine.x, distanceToLine.y ), 1.0 );\n"
+                                      "}\n"
+                                      "void main() {\n"
+                                      "  float distanceToCamera = distance( eyePosition, worldPosition );\n"
+                                      "  float fine = lines( gridStep ) * ( 1.0 - smoothstep( cameraThreshold * 0.5, cameraThreshold, distanceToCamera ) );\n"
+                                      "  float coarse = lines( gridStepCoarse ) * ( 1.0 - smoothstep( cameraThresholdCoarse * 0.5, cameraThresholdCoarse, distanceToCamera ) );\n"
+                                      "  if( max( fine, coarse ) < 0.01 ) {\n"
+                                      "    discard;\n"
+                                      "  }\n"
+                                      "  fragColor = coarse >= fine ? vec4( colorCoarse.rgb, coarse ) : vec4( color.rgb, fine );\n"
+                                      "}\n" );
+
+  Qt3DRender::QTechnique* createTechnique( Qt3DCore::QNode* parent,
+                                           Qt3DRender::QGraphicsApiFilter::Api api,
+                                           int majorVersion, int minorVersion,
+                                           const QByteArray& vertexHeader,
+                                           const QByteArray& fragmentHeader,
+                                           const QStringList& extensions = QStringList() ) {
+    auto* technique = new Qt3DRender::QTechnique( parent );
+    technique->graphicsApiFilter()->setApi( api );
+    technique->graphicsApiFilter()->setProfile( Qt3DRender::QGraphicsApiFilter::NoProfile );
+    technique->graphicsApiFilter()->setMajorVersion( majorVersion );
+    technique->graphicsApiFilter()->setMinorVersion( minorVersion );
+    technique->graphicsApiFilter()->setExtensions( extensions );
+
+    // the forward renderer of Qt3DWindow only draws techniques with this key
+    auto* filterKey = new Qt3DRender::QFilterKey( technique );
+    filterKey->setName( QStringLiteral( "renderingStyle" ) );
+    filterKey->setValue( QStringLiteral( "forward" ) );
+    technique->addFilterKey( filterKey );
+
+    auto* shaderProgram = new Qt3DRender::QShaderProgram( technique );
+    shaderProgram->setVertexShaderCode( vertexHeader + vertexShader );
+    shaderProgram->setFragmentShaderCode( fragmentHeader + fragmentShader );
+
+    auto* renderPass = new Qt3DRender::QRenderPass( technique );
+    renderPass->setShaderProgram( shaderProgram );
+
+    // blend the faded lines over the ground, but don't hide anything behind them
+    auto* blendEquation = new Qt3DRender::QBlendEquation( renderPass );
+    blendEquation->setBlendFunction( Qt3DRender::QBlendEquation::Add );
+    auto* blendEquationArguments = new Qt3DRender::QBlendEquationArguments( renderPass );
+    blendEquationArguments->setSourceRgb( Qt3DRender::QBlendEquationArguments::SourceAlpha );
+    blendEquationArguments->setDestinationRgb( Qt3DRender::QBlendEquationArguments::OneMinusSourceAlpha );
+    blendEquationArguments->setSourceAlpha( Qt3DRender::QBlendEquationArguments::Zero );
+    blendEquationArguments->setDestinationAlpha( Qt3DRender::QBlendEquationArguments::One );
+    renderPass->addRenderState( blendEquation );
+    renderPass->addRenderState( blendEquationArguments );
+    renderPass->addRenderState( new Qt3DRender::QNoDepthMask( renderPass ) );
+
+    technique->addRenderPass( renderPass );
+
+    return technique;
+  }
+}
+
+GridMaterial::GridMaterial( Qt3DCore::QNode* parent )
+  : Qt3DRender::QMaterial( parent ),
+    m_stepParameter( new Qt3DRender::QParameter( QStringLiteral( "gridStep" ), QVector2D( 1, 1 ), this ) ),
+    m_stepCoarseParameter( new Qt3DRender::QParameter( QStringLiteral( "gridStepCoarse" ), QVector2D( 10, 10 ), this ) ),
+    m_cameraThresholdParameter( new Qt3DRender::QParameter( QStringLiteral( "cameraThreshold" ), 75.0f, this ) ),
+    m_cameraThresholdCoarseParameter( new Qt3DRender::QParameter( QStringLiteral( "cameraThresholdCoarse" ), 250.0f, this ) ),
+    m_colorParameter( new Qt3DRender::QParameter( QStringLiteral( "color" ), QColor( 0x6b, 0x96, 0xa8 ), this ) ),
+    m_colorCoarseParameter( new Qt3DRender::QParameter( QStringLiteral( "colorCoarse" ), QColor( 0xa2, 0xe3, 0xff ), this ) ) {
+  auto* effect = new Qt3DRender::QEffect( this );
+
+  effect->addTechnique( createTechnique( effect, Qt3DRender::QGraphicsApiFilter::OpenGL, 3, 2,
+                                         QByteArrayLiteral( "#version 150 core\n" ),
+                                         QByteArrayLiteral( "#version 150 core\n"
+                                             "out vec4 fragColor;\n" ) ) );
+  effect->addTechnique( createTechnique( effect, Qt3DRender::QGraphicsApiFilter::OpenGLES, 3, 0,
+                                         QByteArrayLiteral( "#version 300 es\n"
+                                             "precision highp float;\n" ),
+                                         QByteArrayLiteral( "#version 300 es\n"
+                                             "precision highp float;\n"
+                                             "out vec4 fragColor;\n" ) ) );
+
+  // fwidth() is part of GLSL 1.10, but needs an extension on ES 2; without it, there is no technique and
+  // the grid isn't drawn (SettingsDialog doesn't offer the procedural grid then)
+  effect->addTechnique( createTechnique( effect, Qt3DRender::QGraphicsApiFilter::OpenGL, 2, 0,
+                                         QByteArrayLiteral( "#version 110\n"
+                                             "#define in attribute\n"
+                                             "#define out varying\n" ),
+                                         QByteArrayLiteral( "#version 110\n"
+                                             "#define in varying\n"
+                                             "#define fragColor gl_FragColor\n" ) ) );
+  effect->addTechnique( createTechnique( effect, Qt3DRender::QGraphicsApiFilter::OpenGLES, 2, 0,
+                                         QByteArrayLiteral( "#version 100\n"
+                                             "precision highp float;\n"
+                                             "#define in attribute\n"
+                                             "#define out varying\n" ),
+                                         QByteArrayLiteral( "#version 100\n"
+                                             "#extension GL_OES_standard_derivatives : enable\n"
+                                             "#ifdef GL_FRAGMENT_PRECISION_HIGH\n"
+                                             "precision highp float;\n"
+                                             "#else\n"
+                                             "precision mediump float;\n"
+                                             "#endif\n"
+                                             "#define in varying\n"
+                                             "#define fragColor gl_FragColor\n" ),
+                                         QStringList( QStringLiteral( "GL_OES_standard_derivatives" ) ) ) );
+
+  addParameter( m_stepParameter );
+  addParameter( m_stepCoarseParameter );
+  addParameter( m_cameraThresholdParameter );
+  addParameter( m_cameraThresholdCoarseParameter );
+  addParameter( m_colorParameter );
+  addParameter( m_colorCoarseParameter );
+  setEffect( effect );
+}
+
+void GridMaterial::setSteps( const QVector2D& step, const QVector2D& stepCoarse ) {
+  m_stepParameter->setValue( step );
+  m_stepCoarseParameter->setValue( stepCoarse );
+}
+
+void GridMaterial::setCameraThresholds( float cameraThreshold, float cameraThresholdCoarse ) {
+  m_cameraThresholdParameter->setValue( cameraThreshold );
+  m_cameraThresholdCoarseParameter->setValue( cameraThresholdCoarse );
+}
+
+void GridMaterial::setColors( const QColor& color, const QColor& colorCoarse ) {
+  m_colorParameter->setValue( color );
+  m_colorCoarseParameter->setValue( colorCoarse );
+}
@@ -0,0 +1,50 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QColor>
+#include <QVector2D>
+#include <Qt3DRender/QMaterial>
+
+namespace Qt3DRender {
+  class QParameter;
+}
+
+// draws a fine and a coarse grid in the fragment shader, in world coordinates. Put on a flat mesh
+// in the xy-plane, the cost only depends on the pixels covered, not on the size or the steps of the
+// grid. The lines are faded out by the distance to the camera: the fine ones at cameraThreshold,
+// the coarse ones at cameraThresholdCoarse
+class GridMaterial : public Qt3DRender::QMaterial {
+    Q_OBJECT
+
+  public:
+    explicit GridMaterial( Qt3DCore::QNode* parent = nullptr );
+
+    void setSteps( const QVector2D& step, const QVector2D& stepCoarse );
+    void setCameraThresholds( float cameraThreshold, float cameraThresholdCoarse );
+    void setColors( const QColor& color, const QColor& colorCoarse );
+
+  private:
+    Qt3DRender::QParameter* m_stepParameter = nullptr;
+    Qt3DRender::QParameter* m_stepCoarseParameter = nullptr;
+    Qt3DRender::QParameter* m_cameraThresholdParameter = nullptr;
+    Qt3DRender::QParameter* m_cameraThresholdCoarseParameter = nullptr;
+    Qt3DRender::QParameter* m_colorParameter = nullptr;
+    Qt3DRender::QParameter* m_colorCoarseParameter = nullptr;
+};
@@ -0,0 +1,181 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "InstancedMarkerMaterial.h"
+
+#include <Qt3DRender/QEffect>
+#include <Qt3DRender/QTechnique>
+#include <Qt3DRender/QRenderPass>
+#include <Qt3DRender/QShaderProgram>
+#include <Qt3DRender/QFilterKey>
+#include <Qt3DRender/QParameter>
+#include <Qt3DRender/QGraphicsApiFilter>
+
+namespace {
+  const QByteArray vertexShaderGL3 = QByteArrayLiteral(
+                                       "#version 150 core\n"
+                                       "in vec3 vertexPosition;\n"
+                                       "in vec3 vertexNormal;\n"
+                                       "in vec3 instanceOffset;\n"
+                                       "out vec3 normal;\n"
+                                       "uniform mat4 mvp;\n"
+                                       "uniform mat3 modelViewNormal;\n"
+                                       "void main() {\n"
+                                       "  normal = normalize( modelViewNormal * vertexNormal );\n"
+                                       "  gl_Position = mvp * vec4( vertexPosition + instanceOffset, 1.0 );\n"
+                                       "}\n" );
+
+  const QByteArray fragmentShaderGL3 = QByteArrayLiteral(
+                                         "#version 150 core\n"
+                                         "in vec3 normal;\n"
+                                         "out vec4 fragColor;\n"
+                                         "uniform vec4 diffuse;\n"
+                                         "void main() {\n"
+                                         "  fragColor = vec4( diffuse.rgb * ( 0.4 + 0.6 * abs( normalize( normal ).z ) ), 1.0 );\n"
+                                         "}\n" );
+
+  const QByteArray vertexShaderES3 = QByteArrayLiteral(
+                                       "#version 300 es\n"
+                                       "in vec3 vertexPosition;\n"
+                                       "in vec3 vertexNormal;\n"
+                                       "in vec3 instanceOffset;\n"
+                                       "out vec3 normal;\n"
+                                       "uniform mat4 mvp;\n"
+                                       "uniform mat3 modelViewNormal;\n"
+                                       "void main() {\n"
+                                       "  normal = normalize( modelViewNormal * vertexNormal );\n"
+                                       "  gl_Position = mvp * vec4( vertexPosition + instanceOffset, 1.0 );\n"
+                                       "}\n" );
+
+  const QByteArray fragmentShaderES3 = QByteArrayLiteral(
+                                         "#version 300 es\n"
+                                         "precision mediump float;\n"
+                                         "in vec3 normal;\n"
+                                         "out vec4 fragColor;\n"
+                                         "uniform vec4 diffuse;\n"
+                                         "void main() {\n"
+                                         "  fragColor = vec4( diffuse.rgb * ( 0.4 + 0.6 * abs( normalize( normal ).z ) ), 1.0 );\n"
+                                         "}\n" );
+
+  // without instancing, "instanceOffset" is a per vertex attribute, so these work with both kinds of InstancedMarkerMesh
+  const QByteArray vertexShaderGL2 = QByteArrayLiteral(
+                                       "#version 110\n"
+                                       "attribute vec3 vertexPosition;\n"
+                                       "attribute vec3 vertexNormal;\n"
+                                       "attribute vec3 instanceOffset;\n"
+                                       "varying vec3 normal;\n"
+                                       "uniform mat4 mvp;\n"
+                                       "uniform mat3 modelViewNormal;\n"
+                                       "void main() {\n"
+                                       "  normal = normalize( modelViewNormal * vertexNormal );\n"
+                                       "  gl_Position = mvp * vec4( vertexPosition + instanceOffset, 1.0 );\n"
+                                       "}\n" );
+
+  const QByteArray fragmentShaderGL2 = QByteArrayLiteral(
+                                         "#version 110\n"
+                                         "varying vec3 normal;\n"
+                                         "uniform vec4 diffuse;\n"
+                                         "void main() {\n"
+                                         "  gl_FragColor = vec4( diffuse.rgb * ( 0.4 + 0.6 * abs( normalize( normal ).z ) ), 1.0 );\n"
+                                         "}\n" );
+
+  const QByteArray vertexShaderES2 = QByteArrayLiteral(
+                                       "#version 100\n"
+                                       "attribute vec3 vertexPosition;\n"
+                                       "attribute vec3 vertexNormal;\n"
+                                       "attribute vec3 instanceOffset;\n"
+                                       "varying vec3 normal;\n"
+                                       "uniform mat4 mvp;\n"
+                                       "uniform mat3 modelViewNormal;\n"
+                                       "void main() {\n"
+                                       "  normal = normalize( modelViewNormal * vertexNormal );\n"
+                                       "  gl_Position = mvp * vec4( vertexPosition + instanceOffset, 1.0 );\n"
+                                       "}\n" );
+
+  const QByteArray fragmentShaderES2 = QByteArrayLiteral(
+                                         "#version 100\n"
+                                         "precision mediump float;\n"
+                                         "varying vec3 normal;\n"
+                                         "uniform vec4 diffuse;\n"
+                                         "void main() {\n"
+                                         "  gl_FragColor = vec4( diffuse.rgb * ( 0.4 + 0.6 * abs( normalize( normal ).z ) ), 1.0 );\n"
+                                         "}\n" );
+
+  Qt3DRender::QTechnique* createTechnique( Qt3DCore::QNode* parent,
+                                           Qt3DRender::QGraphicsApiFilter::Api api,
+                                           Qt3DRender::QGraphicsApiFilter::OpenGLProfile profile,
+                                           int majorVersion, int minorVersion,
+                                           const QByteArray& vertexShader,
+                                           const QByteArray& fragmentShader ) {
+    auto* technique = new Qt3DRender::QTechnique( parent );
+    technique->graphicsApiFilter()->setApi( api );
+    technique->graphicsApiFilter()->setProfile( profile );
+    technique->graphicsApiFilter()->setMajorVersion( majorVersion );
+    technique->graphicsApiFilter()->setMinorVersion( minorVersion );
+
+    // the forward renderer of Qt3DWindow only draws techniques with this key
+    auto* filterKey = new Qt3DRender::QFilterKey( technique );
+    filterKey->setName( QStringLiteral( "renderingStyle" ) );
+    filterKey->setValue( QStringLiteral( "forward" ) );
+    technique->addFilterKey( filterKey );
+
+    auto* shaderProgram = new Qt3DRender::QShaderProgram( technique );
+    shaderProgram->setVertexShaderCode( vertexShader );
+    shaderProgram->setFragmentShaderCode( fragmentShader );
+
+    auto* renderPass = new Qt3DRender::QRenderPass( technique );
+    renderPass->setShaderProgram( shaderProgram );
+    technique->addRenderPass( renderPass );
+
+    return technique;
+  }
+}
+
+InstancedMarkerMaterial::InstancedMarkerMaterial( Qt3DCore::QNode* parent )
+  : Qt3DRender::QMaterial( parent ),
+    m_diffuseParameter( new Qt3DRender::QParameter( QStringLiteral( "diffuse" ), QColor( Qt::gray ), this ) ) {
+  auto* effect = new Qt3DRender::QEffect( this );
+
+  effect->addTechnique( createTechnique( effect,
+                                         Qt3DRender::QGraphicsApiFilter::OpenGL,
+                                         Qt3DRender::QGraphicsApiFilter::NoProfile,
+                                         3, 2,
+                                         vertexShaderGL3, fragmentShaderGL3 ) );
+  effect->addTechnique( createTechnique( effect,
+                                         Qt3DRender::QGraphicsApiFilter::OpenGLES,
+                                         Qt3DRender::QGraphicsApiFilter::NoProfile,
+                                         3, 0,
+                                         vertexShaderES3, fragmentShaderES3 ) );
+  effect->addTechnique( createTechnique( effect,
+                                         Qt3DRender::QGraphicsApiFilter::OpenGL,
+                                         Qt3DRender::QGraphicsApiFilter::NoProfile,
+                                         2, 0,
+                                         vertexShaderGL2, fragmentShaderGL2 ) );
+  effect->addTechnique( createTechnique( effect,
+                                         Qt3DRender::QGraphicsApiFilter::OpenGLES,
+                                         Qt3DRender::QGraphicsApiFilter::NoProfile,
+                                         2, 0,
+                                         vertexShaderES2, fragmentShaderES2 ) );
+
+  addParameter( m_diffuseParameter );
+  setEffect( effect );
+}
+
+void InstancedMarkerMaterial::setDiffuse( const QColor& diffuse ) {
+  m_diffuseParameter->setValue( diffuse );
+}
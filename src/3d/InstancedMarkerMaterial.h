@@ -0,0 +1,42 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QColor>
+#include <Qt3DRender/QMaterial>
+
+namespace Qt3DRender {
+  class QParameter;
+}
+
+// a simple diffuse material, which moves every instance by its "instanceOffset" (see InstancedMarkerMesh).
+// The light comes from the camera, so the markers look the same from all sides.
+// Has techniques for OpenGL 3.2 / ES 3.0 and a fallback for OpenGL 2.0 / ES 2.0, which only works with
+// a non-instanced InstancedMarkerMesh
+class InstancedMarkerMaterial : public Qt3DRender::QMaterial {
+    Q_OBJECT
+
+  public:
+    explicit InstancedMarkerMaterial( Qt3DCore::QNode* parent = nullptr );
+
+    void setDiffuse( const QColor& diffuse );
+
+  private:
+    Qt3DRender::QParameter* m_diffuseParameter = nullptr;
+};
@@ -0,0 +1,166 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "InstancedMarkerMesh.h"
+
+#include <Qt3DRender/QGeometry>
+#include <Qt3DExtras/QSphereGeometry>
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+  // a marker is only a few pixels on the screen, so a coarse sphere is enough
+  constexpr int slices = 8;
+  constexpr int rings = 6;
+
+  // the triangles of a sphere with radius 1; the positions are the normals too
+  QVector<QVector3D> sphereTriangles() {
+    auto vertex = []( int ring, int slice ) {
+      const float theta = float( M_PI ) * float( ring ) / rings;
+      const float phi = 2 * float( M_PI ) * float( slice ) / slices;
+      return QVector3D( std::sin( theta ) * std::cos( phi ), std::sin( theta ) * std::sin( phi ), std::cos( theta ) );
+    };
+
+    QVector<QVector3D> triangles;
+    triangles.reserve( slices * ( rings - 1 ) * 6 );
+
+    for( int ring = 0; ring < rings; ++ring ) {
+      for( int slice = 0; slice < slices; ++slice ) {
+        const QVector3D a = vertex( ring, slice );
+        const QVector3D b = vertex( ring + 1, slice );
+        const QVector3D c = vertex( ring + 1, slice + 1 );
+        const QVector3D d = vertex( ring, slice + 1 );
+
+        // the triangles at the poles would be degenerated
+        if( ring != rings - 1 ) {
+          triangles << a << b << c;
+        }
+
+        if( ring != 0 ) {
+          triangles << a << c << d;
+        }
+      }
+    }
+
+    return triangles;
+  }
+
+  Qt3DRender::QAttribute* createAttribute( Qt3DRender::QGeometry* geometry, Qt3DRender::QBuffer* buffer, const QString& name,
+                                           uint byteOffset, uint byteStride ) {
+    auto* attribute = new Qt3DRender::QAttribute( geometry );
+    attribute->setName( name );
+    attribute->setAttributeType( Qt3DRender::QAttribute::VertexAttribute );
+    attribute->setBuffer( buffer );
+    attribute->setVertexBaseType( Qt3DRender::QAttribute::Float );
+    attribute->setVertexSize( 3 );
+    attribute->setByteOffset( byteOffset );
+    attribute->setByteStride( byteStride );
+    attribute->setCount( 0 );
+    geometry->addAttribute( attribute );
+    return attribute;
+  }
+}
+
+InstancedMarkerMesh::InstancedMarkerMesh( Qt3DCore::QNode* parent, bool instanced )
+  : Qt3DRender::QGeometryRenderer( parent ),
+    m_instanced( instanced ) {
+  if( m_instanced ) {
+    auto* sphereGeometry = new Qt3DExtras::QSphereGeometry( this );
+    sphereGeometry->setSlices( slices );
+    sphereGeometry->setRings( rings );
+    sphereGeometry->setRadius( .2f );
+    m_geometry = sphereGeometry;
+
+    m_offsetBuffer = new Qt3DRender::QBuffer( m_geometry );
+    m_offsetAttribute = createAttribute( m_geometry, m_offsetBuffer, QStringLiteral( "instanceOffset" ), 0, sizeof( QVector3D ) );
+    m_offsetAttribute->setDivisor( 1 );
+
+    setInstanceCount( 0 );
+  } else {
+    m_geometry = new Qt3DRender::QGeometry( this );
+    m_radius = .2f;
+
+    // position, normal and offset of a vertex, interleaved
+    const uint stride = 3 * sizeof( QVector3D );
+    m_offsetBuffer = new Qt3DRender::QBuffer( m_geometry );
+    m_positionAttribute = createAttribute( m_geometry, m_offsetBuffer, Qt3DRender::QAttribute::defaultPositionAttributeName(), 0, stride );
+    m_normalAttribute = createAttribute( m_geometry, m_offsetBuffer, Qt3DRender::QAttribute::defaultNormalAttributeName(), sizeof( QVector3D ), stride );
+    m_offsetAttribute = createAttribute( m_geometry, m_offsetBuffer, QStringLiteral( "instanceOffset" ), 2 * sizeof( QVector3D ), stride );
+
+    setInstanceCount( 1 );
+    setVertexCount( 0 );
+  }
+
+  setPrimitiveType( Qt3DRender::QGeometryRenderer::Triangles );
+  setFirstInstance( 0 );
+  setGeometry( m_geometry );
+}
+
+InstancedMarkerMesh::~InstancedMarkerMesh() {
+  m_geometry->deleteLater();
+}
+
+void InstancedMarkerMesh::setRadius( float radius ) {
+  if( m_instanced ) {
+    static_cast<Qt3DExtras::QSphereGeometry*>( m_geometry )->setRadius( radius );
+  } else {
+    m_radius = radius;
+    updateVertices();
+  }
+}
+
+void InstancedMarkerMesh::updatePositions( const QVector<QVector3D>& positions ) {
+  if( m_instanced ) {
+    QByteArray offsetBufferData;
+    offsetBufferData.resize( positions.size() * static_cast<int>( sizeof( QVector3D ) ) );
+    std::memcpy( offsetBufferData.data(), positions.constData(), static_cast<size_t>( offsetBufferData.size() ) );
+    m_offsetBuffer->setData( offsetBufferData );
+
+    m_offsetAttribute->setCount( uint( positions.size() ) );
+    setInstanceCount( positions.size() );
+  } else {
+    m_positions = positions;
+    updateVertices();
+  }
+}
+
+void InstancedMarkerMesh::updateVertices() {
+  static const QVector<QVector3D> triangles = sphereTriangles();
+
+  const int numVertices = m_positions.size() * triangles.size();
+
+  QByteArray vertexBufferData;
+  vertexBufferData.resize( numVertices * 3 * static_cast<int>( sizeof( QVector3D ) ) );
+  auto* vertices = reinterpret_cast<QVector3D*>( vertexBufferData.data() );
+
+  for( const auto& position : qAsConst( m_positions ) ) {
+    for( const auto& vertex : triangles ) {
+      *vertices++ = vertex * m_radius;
+      *vertices++ = vertex;
+      *vertices++ = position;
+    }
+  }
+
+  m_offsetBuffer->setData( vertexBufferData );
+
+  m_positionAttribute->setCount( uint( numVertices ) );
+  m_normalAttribute->setCount( uint( numVertices ) );
+  m_offsetAttribute->setCount( uint( numVertices ) );
+  setVertexCount( numVertices );
+}
@@ -0,0 +1,63 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QVector>
+#include <QVector3D>
+#include <QGeometryRenderer>
+#include <QAttribute>
+#include <Qt3DRender/QBuffer>
+
+namespace Qt3DRender {
+  class QGeometry;
+}
+
+// draws a low-poly sphere at every position with a single instanced draw call. The positions are
+// passed to the shader as per instance attribute "instanceOffset", so it has to be used together
+// with InstancedMarkerMaterial.
+// Without instancing (OpenGL 2 and OpenGL ES 2), the sphere is repeated for every position in one
+// vertex buffer instead, with "instanceOffset" as per vertex attribute; still one draw call, but a
+// lot more memory per position
+class InstancedMarkerMesh : public Qt3DRender::QGeometryRenderer {
+    Q_OBJECT
+
+  public:
+    explicit InstancedMarkerMesh( Qt3DCore::QNode* parent = nullptr, bool instanced = true );
+    ~InstancedMarkerMesh();
+
+    void setRadius( float radius );
+
+    void updatePositions( const QVector<QVector3D>& positions );
+
+  private:
+    void updateVertices();
+
+  private:
+    bool m_instanced = true;
+
+    Qt3DRender::QGeometry* m_geometry = nullptr;
+    Qt3DRender::QAttribute* m_offsetAttribute = nullptr;
+    Qt3DRender::QBuffer* m_offsetBuffer = nullptr;
+
+    // without instancing: position, normal and offset per vertex in one buffer
+    Qt3DRender::QAttribute* m_positionAttribute = nullptr;
+    Qt3DRender::QAttribute* m_normalAttribute = nullptr;
+    float m_radius = 1;
+    QVector<QVector3D> m_positions;
+};
@@ -80,19 +80,7 @@ class BlockFactory : public QObject {
     }
 
     bool isIdUnique( QGraphicsScene* scene, int id ) {
-      const auto& constRefOfList = scene->items();
-
-      for( const auto& item : constRefOfList ) {
-        auto* block = qgraphicsitem_cast<QNEBlock*>( item );
-
-        if( block != nullptr ) {
-          if( block->id == id ) {
-            return false;
-          }
-        }
-      }
-
-      return true;
+      return QNEBlock::getBlockWithId( scene, id ) == nullptr;
     }
 
   protected:
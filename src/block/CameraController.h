@@ -32,7 +32,7 @@
 #include "BlockBase.h"
 
 #include "../kinematic/cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 
 #pragma once
 
@@ -107,11 +107,11 @@ class CameraController : public BlockBase {
       }
     }
 
-    void setPose( const Point_3 position, QQuaternion orientation, PoseOption::Options options ) {
-      if( m_mode == 0 && !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
-        m_cameraEntity->setPosition( convertPoint3ToQVector3D( position ) +
-                                     ( QQuaternion::fromEulerAngles( 0, 0, orientation.toEulerAngles().z() ) * m_offset ) );
-        m_cameraEntity->setViewCenter( convertPoint3ToQVector3D( position ) );
+    void setPose( const Pose& pose ) {
+      if( m_mode == 0 && !pose.options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
+        m_cameraEntity->setPosition( convertPoint3ToQVector3D( pose.position ) +
+                                     ( QQuaternion::fromEulerAngles( 0, 0, pose.orientation.toEulerAngles().z() ) * m_offset ) );
+        m_cameraEntity->setViewCenter( convertPoint3ToQVector3D( pose.position ) );
         m_cameraEntity->setUpVector( QVector3D( 0, 0, 1 ) );
         m_cameraEntity->rollAboutViewCenter( 0 );
         m_cameraEntity->tiltAboutViewCenter( 0 );
@@ -242,7 +242,7 @@ class CameraControllerFactory : public BlockFactory {
       auto* obj = new CameraController( m_rootEntity, m_cameraEntity );
       auto* b = createBaseBlock( scene, obj, id, true );
 
-      b->addInputPort( QStringLiteral( "View Center Position" ), QLatin1String( SLOT( setPose( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "View Center Position" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
 
       return b;
     }
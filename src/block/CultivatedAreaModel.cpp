@@ -61,19 +61,19 @@ void CultivatedAreaModel::emitConfigSignals() {
   emit layerChanged( m_layer );
 }
 
-void CultivatedAreaModel::setPose( const Point_3 position, const QQuaternion orientation, const PoseOption::Options options ) {
-  if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
+void CultivatedAreaModel::setPose( const Pose& pose ) {
+  if( !pose.options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
     if( implement != nullptr ) {
-      m_baseTransform->setTranslation( QVector3D( 0, 0, position.z() ) );
+      m_baseTransform->setTranslation( QVector3D( 0, 0, pose.position.z() ) );
 
       for( size_t i = 0, end = sectionMeshes.size(); i < end; ++i ) {
         const auto mesh = sectionMeshes.at( i );
 
         if( mesh != nullptr ) {
-          QVector3D positionCorrectionLeft = orientation * QVector3D( 0, sectionOffsets.at( i * 2 ), 0 );
-          QVector3D positionCorrectionRight = orientation * QVector3D( 0, sectionOffsets.at( ( i * 2 ) + 1 ), 0 );
+          QVector3D positionCorrectionLeft = pose.orientation * QVector3D( 0, sectionOffsets.at( i * 2 ), 0 );
+          QVector3D positionCorrectionRight = pose.orientation * QVector3D( 0, sectionOffsets.at( ( i * 2 ) + 1 ), 0 );
 
-          Point_2 point2D = to2D( position );
+          Point_2 point2D = to2D( pose.position );
           auto pointLeft = Point_2( point2D.x() + double( positionCorrectionLeft.x() ),
                                     point2D.y() + double( positionCorrectionLeft.y() ) );
           auto pointRight = Point_2( point2D.x() + double( positionCorrectionRight.x() ),
@@ -33,7 +33,7 @@
 #include "BlockBase.h"
 
 #include "../kinematic/cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 
 #include "../block/Implement.h"
 
@@ -50,7 +50,7 @@ class CultivatedAreaModel : public BlockBase {
     virtual void emitConfigSignals() override;
 
   public slots:
-    void setPose( const Point_3, const QQuaternion, const PoseOption::Options );
+    void setPose( const Pose& );
     void setImplement( const QPointer<Implement>& );
     void setSections();
 
@@ -91,7 +91,7 @@ class CultivatedAreaModelFactory : public BlockFactory {
       auto* obj = new CultivatedAreaModel( rootEntity, threadForCgalWorker );
       auto* b = createBaseBlock( scene, obj, id );
 
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
       b->addInputPort( QStringLiteral( "Implement Data" ), QLatin1String( SLOT( setImplement( const QPointer<Implement> ) ) ) );
       b->addInputPort( QStringLiteral( "Section Control Data" ), QLatin1String( SLOT( setSections() ) ) );
 
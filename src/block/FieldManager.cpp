@@ -20,9 +20,13 @@
 #include <QScopedPointer>
 
 #include <QFileDialog>
+#include <QtConcurrent/QtConcurrentRun>
 
 #include "../kinematic/cgal.h"
 #include "../kinematic/CgalWorker.h"
+#include "../kinematic/FieldData.h"
+#include "../kinematic/FieldGeoJson.h"
+#include "../kinematic/FieldBinary.h"
 
 FieldManager::FieldManager( QWidget* mainWindow, Qt3DCore::QEntity* rootEntity, GeographicConvertionWrapper* tmw )
   : BlockBase(),
@@ -98,11 +102,32 @@ FieldManager::FieldManager( QWidget* mainWindow, Qt3DCore::QEntity* rootEntity,
 
     QObject::connect( this, &FieldManager::requestFieldOptimition, cgalWorker, &CgalWorker::fieldOptimitionWorker );
     QObject::connect( cgalWorker, &CgalWorker::alphaChanged, this, &FieldManager::alphaChanged );
+    QObject::connect( cgalWorker, &CgalWorker::fieldOptimitionProgress, this, &FieldManager::fieldOptimitionProgress );
     QObject::connect( cgalWorker, &CgalWorker::fieldStatisticsChanged, this, &FieldManager::fieldStatisticsChanged );
     QObject::connect( cgalWorker, &CgalWorker::alphaShapeFinished, this, &FieldManager::alphaShapeFinished );
 
+    QObject::connect( this, &FieldManager::requestFieldPreview, cgalWorker, &CgalWorker::fieldPreviewWorker );
+    QObject::connect( this, &FieldManager::requestFieldPreviewReset, cgalWorker, &CgalWorker::resetFieldPreview );
+    QObject::connect( cgalWorker, &CgalWorker::fieldPreviewFinished, this, &FieldManager::fieldPreviewFinished );
+
     threadForCgalWorker->start();
   }
+
+  // refresh the preview of the boundary once a second while recording
+  {
+    previewTimer = new QTimer( this );
+    previewTimer->setInterval( 1000 );
+    QObject::connect( previewTimer, &QTimer::timeout, this, &FieldManager::updateFieldPreview );
+  }
+
+  // the fields of the library are read on a thread of the pool
+  {
+    libraryFieldWatcher = new QFutureWatcher<std::shared_ptr<FieldData>>( this );
+    QObject::connect( libraryFieldWatcher, &QFutureWatcher<std::shared_ptr<FieldData>>::finished, this, &FieldManager::libraryFieldLoaded );
+
+    libraryScanWatcher = new QFutureWatcher<std::shared_ptr<FieldLibrary::Index>>( this );
+    QObject::connect( libraryScanWatcher, &QFutureWatcher<std::shared_ptr<FieldLibrary::Index>>::finished, this, &FieldManager::libraryScanned );
+  }
 }
 
 void FieldManager::alphaShape() {
@@ -112,25 +137,94 @@ void FieldManager::alphaShape() {
   // you need at least 3 points for area
   if( points.size() >= 3 ) {
 
-    // make a 2D copy of the recorded points
-    auto pointsCopy2D = new std::vector<Epick::Point_2>();
-    pointsCopy2D->reserve( points.size() );
+    // make a 2D copy of the recorded points, if the worker doesn't have them already
+    std::vector<Epick::Point_2>* pointsCopy2D = nullptr;
 
-    for( const auto& point : points ) {
-      pointsCopy2D->emplace_back( point.x(), point.y() );
+    if( pointsRevisionOfWorker != pointsRevision ) {
+      pointsCopy2D = new std::vector<Epick::Point_2>();
+      pointsCopy2D->reserve( points.size() );
+
+      for( const auto& point : points ) {
+        pointsCopy2D->emplace_back( point.x(), point.y() );
+      }
+
+      pointsRevisionOfWorker = pointsRevision;
     }
 
     emit requestNewRunNumber();
 
     emit requestFieldOptimition( runNumber,
+                                 pointsRevision,
                                  pointsCopy2D,
                                  alphaType,
                                  customAlpha,
                                  maxDeviation,
-                                 distanceBetweenConnectPoints );
+                                 distanceBetweenConnectPoints,
+                                 minDistanceBetweenPoints );
   }
 }
 
+void FieldManager::resetFieldPreview() {
+  pointsInPreview = 0;
+  previewInProgress = false;
+  ++previewGeneration;
+  m_segmentsEntity->setEnabled( false );
+
+  emit requestFieldPreviewReset();
+}
+
+void FieldManager::updateFieldPreview() {
+  // only one preview at a time, the next one takes all the points recorded in the mean time
+  if( previewInProgress || points.size() <= pointsInPreview ) {
+    return;
+  }
+
+  auto newPoints2D = new std::vector<Epick::Point_2>();
+  newPoints2D->reserve( points.size() - pointsInPreview );
+
+  for( auto it = points.cbegin() + long( pointsInPreview ), end = points.cend(); it != end; ++it ) {
+    newPoints2D->emplace_back( it->x(), it->y() );
+  }
+
+  pointsInPreview = points.size();
+  previewInProgress = true;
+
+  emit requestFieldPreview( previewGeneration,
+                            newPoints2D,
+                            alphaType,
+                            customAlpha,
+                            maxDeviation,
+                            distanceBetweenConnectPoints,
+                            minDistanceBetweenPoints );
+}
+
+void FieldManager::fieldPreviewFinished( std::shared_ptr<Polygon_with_holes_2> field, uint32_t generation ) {
+  // reset in the mean time: the preview of the current generation is still in progress, if any
+  if( generation != previewGeneration ) {
+    return;
+  }
+
+  previewInProgress = false;
+
+  // no area yet
+  if( field->outer_boundary().is_empty() ) {
+    m_segmentsEntity->setEnabled( false );
+    return;
+  }
+
+  QVector<QVector3D> meshSegmentPoints;
+  meshSegmentPoints.reserve( int( field->outer_boundary().size() ) + 1 );
+
+  for( auto vi = field->outer_boundary().vertices_begin(), end = field->outer_boundary().vertices_end();
+       vi != end; ++vi ) {
+    meshSegmentPoints << QVector3D( float( vi->x() ), float( vi->y() ), 0.1f );
+  }
+
+  meshSegmentPoints << meshSegmentPoints.first();
+  m_segmentsMesh->bufferUpdate( meshSegmentPoints );
+  m_segmentsEntity->setEnabled( true );
+}
+
 void FieldManager::openField() {
   QString selectedFilter = QStringLiteral( "GeoJSON Files (*.geojson)" );
   QString dir;
@@ -140,7 +234,7 @@ void FieldManager::openField() {
                                       dir,
                                       selectedFilter );
   fileDialog->setFileMode( QFileDialog::ExistingFile );
-  fileDialog->setNameFilter( tr( "All Files (*);;GeoJSON Files (*.geojson)" ) );
+  fileDialog->setNameFilter( tr( "All Files (*);;GeoJSON Files (*.geojson);;Binary Field Files (*.qogfield)" ) );
 
   // connect the signal QFileDialog::urlSelected to a lambda, which opens the file.
   // this is needed, as the file dialog on android is asynchonous, so you have to connect to
@@ -193,117 +287,199 @@ void FieldManager::openField() {
   fileDialog->open();
 }
 
-void FieldManager::openFieldFromFile( QFile& file ) {
-  QByteArray saveData = file.readAll();
+// the binary format is recognised by its magic, everything else is taken as GeoJSON
+static void readFieldFile( QFile& file, GeographicConvertionWrapper& tmw, FieldData& fieldData ) {
+  const bool ok = FieldBinary::isFieldBinary( file ) ?
+                  FieldBinary::read( file, tmw, fieldData ) :
+                  FieldGeoJson::read( file, tmw, fieldData );
+
+  if( !ok ) {
+    qWarning() << "FieldManager::openFieldFromFile: not a valid field:" << file.fileName();
+  }
+}
 
-  QJsonDocument loadDoc( QJsonDocument::fromJson( saveData ) );
-  QJsonObject json = loadDoc.object();
+void FieldManager::openFieldFromFile( QFile& file ) {
+  FieldData fieldData;
+  readFieldFile( file, *tmw, fieldData );
+  setFieldData( fieldData );
+}
 
+void FieldManager::setFieldData( FieldData& fieldData ) {
   bool newField = false;
   bool newRawPoints = false;
 
-  if( json.contains( QStringLiteral( "type" ) ) && json[QStringLiteral( "type" )] == "FeatureCollection" &&
-      json.contains( QStringLiteral( "features" ) ) && json[QStringLiteral( "features" )].isArray() ) {
-    QJsonArray featuresArray = json[QStringLiteral( "features" )].toArray();
+  // processed field
+  if( fieldData.field && fieldData.field->outer_boundary().size() >= 3 ) {
+    currentField = fieldData.field;
+
+    const auto& outerPoly = currentField->outer_boundary();
+    emit pointsInFieldBoundaryChanged( outerPoly.size() );
+
+    QVector<QVector3D> positions;
+    positions.reserve( int( outerPoly.size() ) + 1 );
+
+    for( const auto& vertex : outerPoly.container() ) {
+      positions.push_back( QVector3D( float( vertex.x() ), float( vertex.y() ), 0 ) );
+    }
+
+    positions.push_back( positions.first() );
 
-    for( const auto& feature : qAsConst( featuresArray ) ) {
+    newField = true;
 
-      QJsonObject featuresObject = feature.toObject();
+    m_segmentsMesh2->bufferUpdate( positions );
+    m_segmentsEntity2->setEnabled( true );
 
-      if( featuresObject.contains( QStringLiteral( "type" ) ) && featuresObject[QStringLiteral( "type" )] == "Feature" &&
-          featuresObject.contains( QStringLiteral( "geometry" ) ) && featuresObject[QStringLiteral( "geometry" )].isObject() ) {
-        QJsonObject geometryObject = featuresObject[QStringLiteral( "geometry" )].toObject();
+    emit fieldChanged( currentField );
+  }
+
+  // raw points
+  if( fieldData.hasPoints ) {
+    points.swap( fieldData.points );
+    ++pointsRevision;
+    // the loaded points are shown by m_segmentsMesh3, only the newly recorded ones by m_pointsMesh
+    m_pointsMesh->bufferUpdate( QVector<QVector3D>() );
+    pointsDroppedWhileRecording = 0;
+    resetFieldPreview();
+
+    QVector<QVector3D> positions;
+    positions.reserve( int( points.size() ) );
+
+    for( const auto& point : points ) {
+      positions.push_back( QVector3D( float( point.x() ), float( point.y() ), float( point.z() ) ) );
+    }
+
+    m_segmentsMesh3->bufferUpdate( positions );
+    m_segmentsMesh3->setPrimitiveType( Qt3DRender::QGeometryRenderer::Points );
+    m_segmentsEntity3->setEnabled( true );
+
+    emit pointsGeneratedForFieldBoundaryChanged( 0 );
+    emit pointsRecordedChanged( points.size() );
 
-        if( geometryObject.contains( QStringLiteral( "type" ) ) ) {
-          // processed field
-          if( ( geometryObject[QStringLiteral( "type" )] == "Polygon" || geometryObject[QStringLiteral( "type" )] == "MultiPolygon" ) &&
-              geometryObject.contains( QStringLiteral( "coordinates" ) ) && geometryObject[QStringLiteral( "coordinates" )].isArray() ) {
-            QJsonArray coordinatesArray = geometryObject[QStringLiteral( "coordinates" )].toArray();
+    newRawPoints = true;
+  }
+
+  if( !fieldData.coverageFile.isEmpty() ) {
+    coverageFile = fieldData.coverageFile;
+    emit coverageFileChanged( coverageFile );
+  }
 
-            if( coordinatesArray.size() >= 1 ) {
-              QJsonArray coordinateArray;
+  // if a file is loaded with only raw points, then recalculate() to set it as new boundary
+  if( newRawPoints && ! newField ) {
+    recalculateField();
+  }
+}
 
-              if( geometryObject[QStringLiteral( "type" )] == "MultiPolygon" ) {
-                coordinateArray = coordinatesArray.first().toArray().first().toArray();
-              } else {
-                coordinateArray = coordinatesArray.first().toArray();
-              }
+void FieldManager::openFieldLibrary() {
+  auto* fileDialog = new QFileDialog( mainWindow, tr( "Open Field Library" ), fieldLibrary.directory() );
+  fileDialog->setFileMode( QFileDialog::Directory );
+  fileDialog->setOption( QFileDialog::ShowDirsOnly );
 
-              QVector<QVector3D> positions;
-              Polygon_2 poly;
+  QObject::connect( fileDialog, &QFileDialog::fileSelected, this, [this, fileDialog]( const QString & directory ) {
+    if( !directory.isEmpty() ) {
+      setFieldLibraryDirectory( directory );
+    }
 
-              for( const auto& blockIndex : qAsConst( coordinateArray ) ) {
-                QJsonArray coordinate = blockIndex.toArray();
+    // block all further signals, so no double opening happens
+    fileDialog->blockSignals( true );
 
-                if( coordinate.size() >= 2 ) {
-                  double x, y, z;
+    fileDialog->deleteLater();
+  } );
 
-                  tmw->Forward( coordinate.at( 1 ).toDouble(), coordinate.at( 0 ).toDouble(), x, y, z );
-                  positions.push_back( QVector3D( x, y, z ) );
-                  poly.push_back( Epick::Point_2( x, y ) );
-                }
-              }
+  // connect finished to deleteLater, so the dialog gets deleted when Cancel is pressed
+  QObject::connect( fileDialog, &QFileDialog::finished, fileDialog, &QFileDialog::deleteLater );
 
-              currentField = std::make_shared<Polygon_with_holes_2>( poly );
+  fileDialog->open();
+}
 
-              const auto& outerPoly = currentField->outer_boundary();
-              emit pointsInFieldBoundaryChanged( outerPoly.size() );
+void FieldManager::setFieldLibraryDirectory( const QString& directory ) {
+  // the old library is emptied right away, the new one is there once it is scanned
+  fieldLibrary.clear();
+  fileOfLibrary.clear();
+  fileOfLibraryLoading.clear();
+  lastPositionOfLibraryQuery = Point_2( std::numeric_limits<double>::max(), 0 );
+  directoryOfLibraryScan = directory;
+  rescanLibrary = false;
+
+  if( !directory.isEmpty() ) {
+    // a scan of another directory still running is ignored; setFuture() disconnects the watcher from it
+    libraryScanWatcher->setFuture( QtConcurrent::run( [directory]() {
+      return FieldLibrary::scan( directory );
+    } ) );
+  }
 
-              newField = true;
+  emit fieldLibraryDirectoryChanged( directory );
+}
 
-              m_segmentsMesh2->bufferUpdate( positions );
-              m_segmentsEntity2->setEnabled( true );
+void FieldManager::libraryScanned() {
+  auto index = libraryScanWatcher->result();
 
-              emit fieldChanged( currentField );
-            }
-          }
+  // set to another directory in the mean time
+  if( !index || directoryOfLibraryScan.isEmpty() ) {
+    return;
+  }
 
-          // raw points
-          if( geometryObject[QStringLiteral( "type" )] == "MultiPoint" &&
-              geometryObject.contains( QStringLiteral( "coordinates" ) ) && geometryObject[QStringLiteral( "coordinates" )].isArray() ) {
-            QJsonArray coordinatesArray = geometryObject[QStringLiteral( "coordinates" )].toArray();
+  if( rescanLibrary ) {
+    setFieldLibraryDirectory( directoryOfLibraryScan );
+    return;
+  }
 
-            if( coordinatesArray.size() >= 1 ) {
-              QVector<QVector3D> positions;
-              points.clear();
+  fieldLibrary.setIndex( index );
+  lastPositionOfLibraryQuery = Point_2( std::numeric_limits<double>::max(), 0 );
+}
 
-              for( const auto& blockIndex : qAsConst( coordinatesArray ) ) {
-                QJsonArray coordinate = blockIndex.toArray();
+void FieldManager::selectFieldOfLibrary( const Point_3& position ) {
+  // only look again after moving a meter
+  const Point_2 position2D( position.x(), position.y() );
 
-                if( coordinate.size() >= 2 ) {
-                  double x, y, z;
-                  double height = 0;
+  if( fieldLibrary.numFields() == 0 || CGAL::squared_distance( position2D, lastPositionOfLibraryQuery ) < 1 ) {
+    return;
+  }
 
-                  if( coordinate.size() >= 3 ) {
-                    height = coordinate.at( 2 ).toDouble();
-                  };
+  lastPositionOfLibraryQuery = position2D;
 
-                  tmw->Forward( coordinate.at( 1 ).toDouble(), coordinate.at( 0 ).toDouble(), height, x, y, z );
+  // the boundaries are in memory, so this doesn't touch the disk
+  const QString fileName = fieldLibrary.fieldAt( position2D, *tmw );
 
-                  positions.push_back( QVector3D( x, y, z ) );
+  if( fileName.isEmpty() || fileName == fileOfLibrary || fileName == fileOfLibraryLoading ) {
+    return;
+  }
 
-                  points.emplace_back( Epick::Point_3( x, y, z ) );
-                }
-              }
+  // the next field is looked up again after the current one is loaded
+  if( libraryFieldWatcher->isRunning() ) {
+    lastPositionOfLibraryQuery = Point_2( std::numeric_limits<double>::max(), 0 );
+    return;
+  }
 
-              m_segmentsMesh3->bufferUpdate( positions );
-              m_segmentsMesh3->setPrimitiveType( Qt3DRender::QGeometryRenderer::Points );
-              m_segmentsEntity3->setEnabled( true );
+  fileOfLibraryLoading = fileName;
 
-              emit pointsGeneratedForFieldBoundaryChanged( 0 );
-              emit pointsRecordedChanged( points.size() );
+  // read the file on a thread of the pool with a copy of the conversion, as Forward() changes it
+  GeographicConvertionWrapper tmwCopy = *tmw;
+  libraryFieldWatcher->setFuture( QtConcurrent::run( [fileName, tmwCopy]() mutable {
+    auto fieldData = std::make_shared<FieldData>();
+    QFile file( fileName );
 
-              newRawPoints = true;
-            }
-          }
-        }
-      }
+    if( file.open( QIODevice::ReadOnly ) ) {
+      readFieldFile( file, tmwCopy, *fieldData );
     }
+
+    return fieldData;
+  } ) );
+}
+
+void FieldManager::libraryFieldLoaded() {
+  const QString fileName = fileOfLibraryLoading;
+  fileOfLibraryLoading.clear();
+
+  // started to record or switched off in the mean time: don't replace the field
+  if( !selectFieldFromLibrary || recordContinous ) {
+    return;
   }
 
-  // if a file is loaded with only raw points, then recalculate() to set it as new boundary
-  if( newRawPoints && ! newField ) {
-    recalculateField();
+  auto fieldData = libraryFieldWatcher->result();
+
+  if( fieldData ) {
+    setFieldData( *fieldData );
+    fileOfLibrary = fileName;
   }
 }
 
@@ -314,7 +490,7 @@ void FieldManager::saveField() {
     QString fileName = QFileDialog::getSaveFileName( mainWindow,
                        tr( "Save Field" ),
                        dir,
-                       tr( "All Files (*);;GeoJSON Files (*.geojson)" ),
+                       tr( "All Files (*);;GeoJSON Files (*.geojson);;Binary Field Files (*.qogfield)" ),
                        &selectedFilter );
 
     if( !fileName.isEmpty() ) {
@@ -332,122 +508,46 @@ void FieldManager::saveField() {
 }
 
 void FieldManager::saveFieldToFile( QFile& file ) {
-  QJsonObject jsonObject;
-  QJsonArray features;
-
-  jsonObject[QStringLiteral( "type" )] = QStringLiteral( "FeatureCollection" );
-
-  QJsonObject properties;
-  properties[QStringLiteral( "alpha" )] = currentAlpha;
-  properties[QStringLiteral( "connect-points-distance" )] = distanceBetweenConnectPoints;
-  properties[QStringLiteral( "simplification-max-deviation" )] = maxDeviation;
-
-  // processed field as Polygon
-  if( currentField ) {
-    QJsonObject feature;
-
-    QJsonObject geometry;
-
-    geometry[QStringLiteral( "type" )] = QStringLiteral( "Polygon" );
-
-    QJsonArray coordinatesDummy;
-    QJsonArray coordinates;
-
-    typedef Polygon_2::Vertex_iterator VertexIterator;
-
-    auto outerBoundary = currentField->outer_boundary();
-//    outerBoundary.reverse_orientation();
-
-    for( VertexIterator vi = outerBoundary.vertices_begin(),
-         end = outerBoundary.vertices_end();
-         vi != end; ++vi ) {
-
-      double latitude = 0;
-      double longitude = 0;
-      double height = 0;
-      tmw->Reverse( vi->x(), vi->y(), 0, latitude, longitude, height );
-
-      QJsonArray coordinate;
-      coordinate.push_back( longitude );
-      coordinate.push_back( latitude );
-
-      coordinates.push_back( coordinate );
-    }
-
-
-    // add the first point again
-    {
-      VertexIterator vi = outerBoundary.vertices_begin();
-      double latitude = 0;
-      double longitude = 0;
-      double height = 0;
-
-      tmw->Reverse( vi->x(), vi->y(), 0, latitude, longitude, height );
-
-      QJsonArray coordinate;
-      coordinate.push_back( longitude );
-      coordinate.push_back( latitude );
-
-      coordinates.push_back( coordinate );
-    }
-
-    coordinatesDummy.push_back( coordinates );
-    geometry[QStringLiteral( "coordinates" )] = coordinatesDummy;
-
-    feature[QStringLiteral( "type" )] = QStringLiteral( "Feature" );
-    feature[QStringLiteral( "geometry" )] = geometry;
-
-    properties[QStringLiteral( "name" )] = QStringLiteral( "processed polygon" );
-    feature[QStringLiteral( "properties" )] = properties;
-
-    features.push_back( feature );
+  FieldData fieldData;
+  fieldData.field = currentField;
+  fieldData.hasPoints = !points.empty();
+  fieldData.alpha = currentAlpha;
+  fieldData.distanceBetweenConnectPoints = distanceBetweenConnectPoints;
+  fieldData.maxDeviation = maxDeviation;
+  fieldData.coverageFile = coverageFile;
+
+  // lend the recorded points instead of copying them
+  fieldData.points.swap( points );
+
+  const bool ok = file.fileName().endsWith( QLatin1String( ".qogfield" ), Qt::CaseInsensitive ) ?
+                  FieldBinary::write( file, *tmw, fieldData ) :
+                  FieldGeoJson::write( file, *tmw, fieldData );
+
+  points.swap( fieldData.points );
+
+  if( !ok ) {
+    qWarning() << "FieldManager::saveFieldToFile: couldn't write" << file.fileName();
+    return;
   }
 
-  // recorded points as MultiPoint
-  if( !points.empty() ) {
-    QJsonObject feature;
+  // so it can be selected by position right away; the size and the time of the file are only final after the flush
+  file.flush();
 
-    QJsonObject geometry;
-
-    geometry[QStringLiteral( "type" )] = QStringLiteral( "MultiPoint" );
-
-    QJsonArray coordinates;
-
-    for( const Epick::Point_3& point : points ) {
-
-      double latitude = 0;
-      double longitude = 0;
-      double height = 0;
-      tmw->Reverse( point.x(), point.y(), point.z(), latitude, longitude, height );
-
-      QJsonArray coordinate;
-      coordinate.push_back( longitude );
-      coordinate.push_back( latitude );
-      coordinate.push_back( height );
-
-      coordinates.push_back( coordinate );
-    }
-
-    geometry[QStringLiteral( "coordinates" )] = coordinates;
-
-    feature[QStringLiteral( "type" )] = QStringLiteral( "Feature" );
-    feature[QStringLiteral( "geometry" )] = geometry;
-
-    properties[QStringLiteral( "name" )] = QStringLiteral( "raw points" );
-    feature[QStringLiteral( "properties" )] = properties;
-
-    features.push_back( feature );
+  if( libraryScanWatcher->isRunning() ) {
+    rescanLibrary = true;
+  } else if( fieldLibrary.addField( file.fileName(), currentField, *tmw ) ) {
+    fileOfLibrary = file.fileName();
   }
-
-  jsonObject[QStringLiteral( "features" )] = features;
-
-  QJsonDocument jsonDocument( jsonObject );
-  file.write( jsonDocument.toJson() );
 }
 
 void FieldManager::alphaShapeFinished( std::shared_ptr<Polygon_with_holes_2> field, double /*alpha*/ ) {
   currentField = field;
 
+  // the calculated boundary replaces the preview
+  if( !recordContinous ) {
+    m_segmentsEntity->setEnabled( false );
+  }
+
   QVector<QVector3D> meshSegmentPoints;
   typedef Polygon_2::Vertex_iterator VertexIterator;
 
@@ -25,6 +25,8 @@
 #include <QPointF>
 #include <QPolygonF>
 #include <QLineF>
+#include <QTimer>
+#include <QFutureWatcher>
 
 #include <Qt3DCore/QEntity>
 #include <Qt3DCore/QTransform>
@@ -45,17 +47,20 @@
 #include "../gui/FieldsOptimitionToolbar.h"
 
 #include "../kinematic/cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 #include "../kinematic/PathPrimitive.h"
 
 #include "../kinematic/GeographicConvertionWrapper.h"
+#include "../kinematic/FieldLibrary.h"
 
 #include <QVector>
 #include <QSharedPointer>
 #include <utility>
+#include <limits>
 
 class CgalThread;
 class CgalWorker;
+struct FieldData;
 
 class FieldManager : public BlockBase {
     Q_OBJECT
@@ -67,28 +72,58 @@ class FieldManager : public BlockBase {
 
   private:
     void alphaShape();
+    void resetFieldPreview();
+
+    // opens the field of the library at the position, if it isn't the current one. The file is read on
+    // a thread of the pool, libraryFieldLoaded() shows it
+    void selectFieldOfLibrary( const Point_3& position );
+    void libraryFieldLoaded();
+
+    // the directory of the library is scanned on a thread of the pool, libraryScanned() sets the result
+    void libraryScanned();
+
+    // standing still or driving slowly records dense clusters of points, which only make the
+    // triangulation more expensive: only record a point if it is far enough from the last one
+    void recordContinousPoint( const Point_3& position ) {
+      if( minDistanceBetweenPoints > 0 && !points.empty() &&
+          CGAL::squared_distance( to2D( points.back() ), to2D( position ) ) < ( minDistanceBetweenPoints * minDistanceBetweenPoints ) ) {
+        ++pointsDroppedWhileRecording;
+        return;
+      }
+
+      points.push_back( position );
+      ++pointsRevision;
+      m_pointsMesh->bufferAppend( convertPoint3ToQVector3D( position ) );
+    }
 
   public slots:
-    void setPose( const Point_3 position, const QQuaternion orientation, const PoseOption::Options options ) {
-      if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
-        this->position = position;
-        this->orientation = orientation;
+    void setPose( const Pose& pose ) {
+      if( !pose.options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
+        this->position = pose.position;
+        this->orientation = pose.orientation;
+
+        // don't replace a field while it is recorded
+        if( selectFieldFromLibrary && !recordContinous ) {
+          selectFieldOfLibrary( pose.position );
+        }
       }
     }
 
-    void setPoseLeftEdge( const Point_3 position, const QQuaternion, const PoseOption::Options options ) {
-      if( options.testFlag( PoseOption::CalculateLocalOffsets ) &&
-          options.testFlag( PoseOption::CalculateWithoutOrientation ) ) {
-        positionLeftEdgeOfImplement = position;
+    void setPoseLeftEdge( const Pose& pose ) {
+      if( pose.options.testFlag( PoseOption::CalculateLocalOffsets ) &&
+          pose.options.testFlag( PoseOption::CalculateWithoutOrientation ) ) {
+        positionLeftEdgeOfImplement = pose.position;
       } else {
         if( recordOnRightEdgeOfImplement == false ) {
           if( recordNextPoint ) {
-            points.push_back( position );
+            points.push_back( pose.position );
+            ++pointsRevision;
+            m_pointsMesh->bufferAppend( convertPoint3ToQVector3D( pose.position ) );
             recordNextPoint = false;
             recalculateField();
           } else {
             if( recordContinous ) {
-              points.push_back( position );
+              recordContinousPoint( pose.position );
               recordNextPoint = false;
             }
           }
@@ -98,19 +133,21 @@ class FieldManager : public BlockBase {
       }
     }
 
-    void setPoseRightEdge( const Point_3 position, const QQuaternion, const PoseOption::Options options ) {
-      if( options.testFlag( PoseOption::CalculateLocalOffsets ) &&
-          options.testFlag( PoseOption::CalculateWithoutOrientation ) ) {
-        positionRightEdgeOfImplement = position;
+    void setPoseRightEdge( const Pose& pose ) {
+      if( pose.options.testFlag( PoseOption::CalculateLocalOffsets ) &&
+          pose.options.testFlag( PoseOption::CalculateWithoutOrientation ) ) {
+        positionRightEdgeOfImplement = pose.position;
       } else {
         if( recordOnRightEdgeOfImplement == true ) {
           if( recordNextPoint ) {
-            points.push_back( position );
+            points.push_back( pose.position );
+            ++pointsRevision;
+            m_pointsMesh->bufferAppend( convertPoint3ToQVector3D( pose.position ) );
             recordNextPoint = false;
             recalculateField();
           } else {
             if( recordContinous ) {
-              points.push_back( position );
+              recordContinousPoint( pose.position );
               recordNextPoint = false;
             }
           }
@@ -122,19 +159,43 @@ class FieldManager : public BlockBase {
 
     void openField();
     void openFieldFromFile( QFile& file );
+    void setFieldData( FieldData& fieldData );
 
     void newField() {
+      fileOfLibrary.clear();
       points.clear();
+      ++pointsRevision;
+      m_pointsMesh->bufferUpdate( QVector<QVector3D>() );
+      pointsDroppedWhileRecording = 0;
+      resetFieldPreview();
     }
 
     void saveField();
     void saveFieldToFile( QFile& file );
 
+    // the file of the coverage map, saved with the field in the binary format
+    void setCoverageFile( const QString& fileName ) {
+      coverageFile = fileName;
+    }
+
+    // asks for the directory of the field library
+    void openFieldLibrary();
+    void setFieldLibraryDirectory( const QString& directory );
+    void setSelectFieldFromLibrary( bool enabled ) {
+      selectFieldFromLibrary = enabled;
+    }
+
     void setContinousRecord( bool enabled ) {
       if( recordContinous == true && enabled == false ) {
         recalculateField();
       }
 
+      if( enabled ) {
+        previewTimer->start();
+      } else {
+        previewTimer->stop();
+      }
+
       recordContinous = enabled;
     }
     void recordPoint() {
@@ -149,11 +210,12 @@ class FieldManager : public BlockBase {
       alphaShape();
     }
 
-    void setRecalculateFieldSettings( FieldsOptimitionToolbar::AlphaType alphaType, double customAlpha, double maxDeviation, double distanceBetweenConnectPoints ) {
+    void setRecalculateFieldSettings( FieldsOptimitionToolbar::AlphaType alphaType, double customAlpha, double maxDeviation, double distanceBetweenConnectPoints, double minDistanceBetweenPoints ) {
       this->alphaType = alphaType;
       this->customAlpha = customAlpha;
       this->maxDeviation = maxDeviation;
       this->distanceBetweenConnectPoints = distanceBetweenConnectPoints;
+      this->minDistanceBetweenPoints = minDistanceBetweenPoints;
     }
 
     void setRunNumber( uint32_t runNumber ) {
@@ -162,27 +224,48 @@ class FieldManager : public BlockBase {
 
     void alphaShapeFinished( std::shared_ptr<Polygon_with_holes_2> field, double alpha );
 
-    void fieldStatisticsChanged( double pointsRecorded, double pointsGeneratedForFieldBoundary, double pointsInFieldBoundary ) {
+    // sends the points recorded since the last preview to the worker
+    void updateFieldPreview();
+    void fieldPreviewFinished( std::shared_ptr<Polygon_with_holes_2> field, uint32_t generation );
+
+    void fieldStatisticsChanged( double pointsRecorded, double pointsGeneratedForFieldBoundary, double pointsInFieldBoundary, double pointsDroppedByThinning ) {
       emit pointsRecordedChanged( pointsRecorded );
       emit pointsGeneratedForFieldBoundaryChanged( pointsGeneratedForFieldBoundary );
       emit pointsInFieldBoundaryChanged( pointsInFieldBoundary );
+      emit pointsDroppedChanged( double( pointsDroppedWhileRecording ) + pointsDroppedByThinning );
     }
 
   signals:
     void fieldChanged( std::shared_ptr<Polygon_with_holes_2> );
 
-    void alphaChanged( double optimal, double solid );
+    void alphaChanged( double optimal, double solid, bool estimated );
+    void fieldLibraryDirectoryChanged( const QString& directory );
+    // the coverage map of an opened field
+    void coverageFileChanged( const QString& fileName );
+    void fieldOptimitionProgress( int percent );
     void requestFieldOptimition( uint32_t runNumber,
+                                 uint32_t pointsRevision,
                                  std::vector<Epick::Point_2>* points,
                                  FieldsOptimitionToolbar::AlphaType alphaType,
                                  double customAlpha,
                                  double maxDeviation,
-                                 double distanceBetweenConnectPoints );
+                                 double distanceBetweenConnectPoints,
+                                 double minDistanceBetweenPoints );
     void requestNewRunNumber();
 
+    void requestFieldPreview( uint32_t generation,
+                              std::vector<Epick::Point_2>* newPoints,
+                              FieldsOptimitionToolbar::AlphaType alphaType,
+                              double customAlpha,
+                              double maxDeviation,
+                              double distanceBetweenConnectPoints,
+                              double minDistanceBetweenPoints );
+    void requestFieldPreviewReset();
+
     void pointsRecordedChanged( double );
     void pointsGeneratedForFieldBoundaryChanged( double );
     void pointsInFieldBoundaryChanged( double );
+    void pointsDroppedChanged( double );
 
   public:
     Point_3 position = Point_3( 0, 0, 0 );
@@ -197,6 +280,10 @@ class FieldManager : public BlockBase {
     GeographicConvertionWrapper* tmw = nullptr;
 
     std::vector<Epick::Point_3> points;
+
+    // incremented on every change of points; the CgalWorker keeps the triangulation of the last revision it got
+    uint32_t pointsRevision = 0;
+    uint32_t pointsRevisionOfWorker = std::numeric_limits<uint32_t>::max();
     bool recordContinous = false;
     bool recordNextPoint = false;
     bool recordOnRightEdgeOfImplement = false;
@@ -209,6 +296,8 @@ class FieldManager : public BlockBase {
     double customAlpha = 10;
     double maxDeviation = 0.1;
     double distanceBetweenConnectPoints = 0.5;
+    double minDistanceBetweenPoints = 0.2;
+    std::size_t pointsDroppedWhileRecording = 0;
 
     CgalThread* threadForCgalWorker = nullptr;
     CgalWorker* cgalWorker = nullptr;
@@ -216,6 +305,26 @@ class FieldManager : public BlockBase {
 
     std::shared_ptr<Polygon_with_holes_2> currentField;
     double currentAlpha = 0;
+    QString coverageFile;
+
+    // the saved fields, to select the one the vehicle is in
+    FieldLibrary fieldLibrary;
+    bool selectFieldFromLibrary = false;
+    QString fileOfLibrary;
+    QString fileOfLibraryLoading;
+    QFutureWatcher<std::shared_ptr<FieldData>>* libraryFieldWatcher = nullptr;
+    QFutureWatcher<std::shared_ptr<FieldLibrary::Index>>* libraryScanWatcher = nullptr;
+    QString directoryOfLibraryScan;
+    // a field was saved into the library while scanning it, so the scan might have missed it
+    bool rescanLibrary = false;
+    Point_2 lastPositionOfLibraryQuery = Point_2( 0, 0 );
+
+    // live preview of the boundary while recording continously
+    QTimer* previewTimer = nullptr;
+    std::size_t pointsInPreview = 0;
+    bool previewInProgress = false;
+    // incremented on every reset, the results of the previews requested before are dropped
+    uint32_t previewGeneration = 0;
 
     Qt3DCore::QEntity* m_pointsEntity = nullptr;
     Qt3DCore::QEntity* m_segmentsEntity = nullptr;
@@ -252,15 +361,18 @@ class FieldManagerFactory : public BlockFactory {
       auto* obj = new FieldManager( mainWindow, rootEntity, tmw );
       auto* b = createBaseBlock( scene, obj, id, true );
 
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
-      b->addInputPort( QStringLiteral( "Pose Left Edge" ), QLatin1String( SLOT( setPoseLeftEdge( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
-      b->addInputPort( QStringLiteral( "Pose Right Edge" ), QLatin1String( SLOT( setPoseRightEdge( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose Left Edge" ), QLatin1String( SLOT( setPoseLeftEdge( const Pose& ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose Right Edge" ), QLatin1String( SLOT( setPoseRightEdge( const Pose& ) ) ) );
+      b->addInputPort( QStringLiteral( "Coverage File" ), QLatin1String( SLOT( setCoverageFile( const QString& ) ) ) );
 
       b->addOutputPort( QStringLiteral( "Field" ), QLatin1String( SIGNAL( fieldChanged( std::shared_ptr<Polygon_with_holes_2> ) ) ) );
+      b->addOutputPort( QStringLiteral( "Coverage File" ), QLatin1String( SIGNAL( coverageFileChanged( const QString& ) ) ) );
 
       b->addOutputPort( QStringLiteral( "Points Recorded" ), QLatin1String( SIGNAL( pointsRecordedChanged( double ) ) ) );
       b->addOutputPort( QStringLiteral( "Points Generated" ), QLatin1String( SIGNAL( pointsGeneratedForFieldBoundaryChanged( double ) ) ) );
       b->addOutputPort( QStringLiteral( "Points Boundary" ), QLatin1String( SIGNAL( pointsInFieldBoundaryChanged( double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Points Dropped" ), QLatin1String( SIGNAL( pointsDroppedChanged( double ) ) ) );
 
       return b;
     }
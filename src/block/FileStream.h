@@ -83,6 +83,25 @@ class FileStream : public BlockBase {
       *fileStream << data;
     }
 
+  public:
+    // emits the whole file as fast as possible instead of with the linerate; used by the headless mode
+    qint64 replayAll() {
+      qint64 lines = 0;
+
+      timer.stop();
+
+      if( file && fileStream ) {
+        fileStream->seek( 0 );
+
+        while( !fileStream->atEnd() ) {
+          emit dataReceived( fileStream->readLine().toLatin1() );
+          ++lines;
+        }
+      }
+
+      return lines;
+    }
+
   protected:
     void timerEvent( QTimerEvent* event ) override {
       if( event->timerId() == timer.timerId() ) {
@@ -21,21 +21,38 @@
 #pragma once
 
 #include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QScreen>
+#include <QWindow>
 
 #include <Qt3DCore/QEntity>
 #include <Qt3DLogic/QFrameAction>
 
 #include "BlockBase.h"
 
+#include <algorithm>
+
+// counts the frames of the 3D-view and emits the frame rate every second. With rendering only on changes,
+// the frame rate drops if nothing moves; the part of the refreshes of the screen without a new frame is
+// emitted as idle ratio. The screen is only refreshed every swap interval, so the idle ratio is relative
+// to this effective cap and not to the refresh rate of the screen
 class FpsMeasurement : public BlockBase {
     Q_OBJECT
 
   public:
-    explicit FpsMeasurement( Qt3DCore::QEntity* rootEntity )
-      : BlockBase() {
+    explicit FpsMeasurement( Qt3DCore::QEntity* rootEntity, QWindow* window )
+      : BlockBase(),
+        window( window ) {
       fpsComponent = new Qt3DLogic::QFrameAction( rootEntity );
       rootEntity->addComponent( fpsComponent );
       QObject::connect( fpsComponent, &Qt3DLogic::QFrameAction::triggered, this, &FpsMeasurement::frameActionTriggered );
+
+      timer = new QTimer( this );
+      QObject::connect( timer, &QTimer::timeout, this, &FpsMeasurement::emitFrameRate );
+      timer->start( 1000 );
+      elapsedTimer.start();
     }
 
     ~FpsMeasurement() {
@@ -44,18 +61,43 @@ class FpsMeasurement : public BlockBase {
 
     void emitConfigSignals() override {
       emit fpsChanged( 0 );
+      emit idleChanged( 0 );
     }
 
   public slots:
-    void frameActionTriggered( float dt ) {
-      emit fpsChanged( 1 / dt );
+    void frameActionTriggered( float ) {
+      ++frames;
+    }
+
+    void emitFrameRate() {
+      const double fps = double( frames ) * 1000 / double( std::max( qint64( 1 ), elapsedTimer.restart() ) );
+      frames = 0;
+
+      const auto* screen = window != nullptr ? window->screen() : QGuiApplication::primaryScreen();
+      const double refreshRate = ( screen != nullptr && screen->refreshRate() > 0 ) ? double( screen->refreshRate() ) : 60;
+
+      // the format of the window is the one its surface was created with, so this is the swap interval in use
+      const int swapInterval = window != nullptr ? std::max( 1, window->format().swapInterval() ) : 1;
+      const double maxFps = refreshRate / swapInterval;
+
+      emit fpsChanged( fps );
+      emit idleChanged( std::max( 0.0, 100 * ( 1 - fps / maxFps ) ) );
     }
 
   signals:
     void fpsChanged( double );
 
+    // in %
+    void idleChanged( double );
+
   public:
     Qt3DLogic::QFrameAction* fpsComponent;
+
+  private:
+    QWindow* window = nullptr;
+    QTimer* timer = nullptr;
+    QElapsedTimer elapsedTimer;
+    int frames = 0;
 };
 
 
@@ -64,23 +106,26 @@ class FpsMeasurementFactory : public BlockFactory {
     Q_OBJECT
 
   public:
-    FpsMeasurementFactory( Qt3DCore::QEntity* rootEntity )
+    FpsMeasurementFactory( Qt3DCore::QEntity* rootEntity, QWindow* window )
       : BlockFactory(),
-        rootEntity( rootEntity ) {}
+        rootEntity( rootEntity ),
+        window( window ) {}
 
     QString getNameOfFactory() override {
       return QStringLiteral( "Fps Measurement" );
     }
 
     virtual QNEBlock* createBlock( QGraphicsScene* scene, int id ) override {
-      auto* obj = new FpsMeasurement( rootEntity );
+      auto* obj = new FpsMeasurement( rootEntity, window );
       auto* b = createBaseBlock( scene, obj, id, true );
 
       b->addOutputPort( QStringLiteral( "FPS" ), QLatin1String( SIGNAL( fpsChanged( double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Idle %" ), QLatin1String( SIGNAL( idleChanged( double ) ) ) );
 
       return b;
     }
 
   private:
     Qt3DCore::QEntity* rootEntity = nullptr;
+    QWindow* window = nullptr;
 };
@@ -0,0 +1,263 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+#include <QDebug>
+
+#include <Qt3DCore/QEntity>
+#include <Qt3DLogic/QFrameAction>
+
+#include "BlockBase.h"
+
+#include <algorithm>
+#include <vector>
+
+// keeps the times of the last frames of the 3D-view in a ring buffer and emits the percentiles of them
+// and the frames over the budget every second. Unlike the fps, this shows stutters: a single long frame
+// doesn't change the average much, but the max and the 99th percentile.
+// The time between two frames is measured, so with rendering only on changes, the first frame after an idle
+// time would look like a very long one. Gaps longer than idleThreshold are therefore counted separately and
+// traced with the idle flag set, but are not part of the percentiles; a stutter is always shorter than this.
+// With a trace file set, the buffer is written to it and every following frame is appended
+class FrameTiming : public BlockBase {
+    Q_OBJECT
+
+  public:
+    explicit FrameTiming( Qt3DCore::QEntity* rootEntity )
+      : BlockBase() {
+      frameAction = new Qt3DLogic::QFrameAction( rootEntity );
+      rootEntity->addComponent( frameAction );
+      QObject::connect( frameAction, &Qt3DLogic::QFrameAction::triggered, this, &FrameTiming::frameActionTriggered );
+
+      frames.resize( std::size_t( numFramesInBuffer ) );
+      sortedFrameTimes.reserve( std::size_t( numFramesInBuffer ) );
+
+      timer = new QTimer( this );
+      QObject::connect( timer, &QTimer::timeout, this, &FrameTiming::emitStatistics );
+      timer->start( 1000 );
+    }
+
+    ~FrameTiming() {
+      frameAction->deleteLater();
+      closeTraceFile();
+    }
+
+    void emitConfigSignals() override {
+      emit p50Changed( 0 );
+      emit p95Changed( 0 );
+      emit p99Changed( 0 );
+      emit maxChanged( 0 );
+      emit overBudgetChanged( 0 );
+      emit idleGapsChanged( 0 );
+    }
+
+  public slots:
+    // in ms
+    void setBudget( double budget ) {
+      this->budget = float( budget );
+    }
+
+    void setTraceFile( const QString& fileName ) {
+      closeTraceFile();
+
+      if( !fileName.isEmpty() ) {
+        traceFile = new QFile( fileName );
+
+        if( traceFile->open( QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text ) ) {
+          traceStream.setDevice( traceFile );
+          traceStream << "timestamp [ms];frametime [ms];idle\n";
+
+          // the frames already in the buffer, oldest first
+          for( std::size_t i = 0; i < numFrames; ++i ) {
+            const auto& frame = frames[( nextFrame + numFramesInBuffer - numFrames + i ) % numFramesInBuffer];
+            traceStream << frame.timestamp << ';' << frame.duration << ";0\n";
+          }
+
+          traceStream.flush();
+        } else {
+          qWarning() << "FrameTiming::setTraceFile: can't open" << fileName;
+          closeTraceFile();
+        }
+      }
+    }
+
+    void frameActionTriggered( float dt ) {
+      const qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+      const float duration = dt * 1000;
+
+      // an idle time of the view, not a slow frame
+      if( duration > idleThreshold ) {
+        ++idleGaps;
+
+        if( traceFile != nullptr ) {
+          traceStream << timestamp << ';' << duration << ";1\n";
+        }
+
+        return;
+      }
+
+      auto& frame = frames[nextFrame];
+      frame.timestamp = timestamp;
+      frame.duration = duration;
+
+      nextFrame = ( nextFrame + 1 ) % numFramesInBuffer;
+
+      if( numFrames < numFramesInBuffer ) {
+        ++numFrames;
+      }
+
+      if( frame.duration > budget * budgetTolerance ) {
+        ++framesOverBudget;
+      }
+
+      if( traceFile != nullptr ) {
+        traceStream << frame.timestamp << ';' << frame.duration << ";0\n";
+      }
+    }
+
+    void emitStatistics() {
+      sortedFrameTimes.clear();
+
+      for( std::size_t i = 0; i < numFrames; ++i ) {
+        sortedFrameTimes.push_back( frames[i].duration );
+      }
+
+      std::sort( sortedFrameTimes.begin(), sortedFrameTimes.end() );
+
+      emit p50Changed( double( percentile( 0.5 ) ) );
+      emit p95Changed( double( percentile( 0.95 ) ) );
+      emit p99Changed( double( percentile( 0.99 ) ) );
+      emit maxChanged( sortedFrameTimes.empty() ? 0 : double( sortedFrameTimes.back() ) );
+      emit overBudgetChanged( framesOverBudget );
+      emit idleGapsChanged( idleGaps );
+
+      framesOverBudget = 0;
+      idleGaps = 0;
+
+      if( traceFile != nullptr ) {
+        traceStream.flush();
+      }
+    }
+
+  signals:
+    // in ms
+    void p50Changed( double );
+    void p95Changed( double );
+    void p99Changed( double );
+    void maxChanged( double );
+
+    // in frames/s
+    void overBudgetChanged( double );
+
+    // in gaps/s
+    void idleGapsChanged( double );
+
+  private:
+    float percentile( float p ) const {
+      if( sortedFrameTimes.empty() ) {
+        return 0;
+      }
+
+      return sortedFrameTimes[std::min( sortedFrameTimes.size() - 1, std::size_t( p * sortedFrameTimes.size() ) )];
+    }
+
+    void closeTraceFile() {
+      if( traceFile != nullptr ) {
+        traceStream.flush();
+        traceStream.setDevice( nullptr );
+        traceFile->close();
+        delete traceFile;
+        traceFile = nullptr;
+      }
+    }
+
+  public:
+    Qt3DLogic::QFrameAction* frameAction = nullptr;
+
+  private:
+    struct Frame {
+      // in ms since the epoch
+      qint64 timestamp = 0;
+      // in ms
+      float duration = 0;
+    };
+
+    // about 8s at 60 fps
+    static constexpr std::size_t numFramesInBuffer = 512;
+
+    std::vector<Frame> frames;
+    std::size_t nextFrame = 0;
+    std::size_t numFrames = 0;
+
+    std::vector<float> sortedFrameTimes;
+
+    // in ms; one refresh at 60 Hz
+    float budget = 1000.0f / 60;
+    // the time between two frames jitters around the refresh interval, so a frame is only over the budget if it is clearly longer
+    static constexpr float budgetTolerance = 1.1f;
+    int framesOverBudget = 0;
+
+    // in ms; longer gaps between two frames are idle times with rendering only on changes
+    static constexpr float idleThreshold = 250;
+    int idleGaps = 0;
+
+    QTimer* timer = nullptr;
+
+    QFile* traceFile = nullptr;
+    QTextStream traceStream;
+};
+
+class FrameTimingFactory : public BlockFactory {
+    Q_OBJECT
+
+  public:
+    FrameTimingFactory( Qt3DCore::QEntity* rootEntity )
+      : BlockFactory(),
+        rootEntity( rootEntity ) {}
+
+    QString getNameOfFactory() override {
+      return QStringLiteral( "Frame Timing" );
+    }
+
+    virtual QNEBlock* createBlock( QGraphicsScene* scene, int id ) override {
+      auto* obj = new FrameTiming( rootEntity );
+      auto* b = createBaseBlock( scene, obj, id, true );
+
+      b->addInputPort( QStringLiteral( "Budget" ), QLatin1String( SLOT( setBudget( double ) ) ) );
+      b->addInputPort( QStringLiteral( "Trace File" ), QLatin1String( SLOT( setTraceFile( const QString& ) ) ) );
+
+      b->addOutputPort( QStringLiteral( "p50" ), QLatin1String( SIGNAL( p50Changed( double ) ) ) );
+      b->addOutputPort( QStringLiteral( "p95" ), QLatin1String( SIGNAL( p95Changed( double ) ) ) );
+      b->addOutputPort( QStringLiteral( "p99" ), QLatin1String( SIGNAL( p99Changed( double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Max" ), QLatin1String( SIGNAL( maxChanged( double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Over Budget /s" ), QLatin1String( SIGNAL( overBudgetChanged( double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Idle Gaps /s" ), QLatin1String( SIGNAL( idleGapsChanged( double ) ) ) );
+
+      return b;
+    }
+
+  private:
+    Qt3DCore::QEntity* rootEntity = nullptr;
+};
@@ -24,7 +24,7 @@
 #include "../kinematic/cgal.h"
 #include "../kinematic/CgalWorker.h"
 
-GlobalPlanner::GlobalPlanner( const QString& uniqueName, MyMainWindow* mainWindow, GeographicConvertionWrapper* tmw, Qt3DCore::QEntity* rootEntity )
+GlobalPlanner::GlobalPlanner( const QString& uniqueName, MyMainWindow* mainWindow, GeographicConvertionWrapper* tmw, Qt3DCore::QEntity* rootEntity, bool instancedMarkers )
   : BlockBase(),
     tmw( tmw ),
     mainWindow( mainWindow ),
@@ -108,13 +108,15 @@ GlobalPlanner::GlobalPlanner( const QString& uniqueName, MyMainWindow* mainWindo
   {
     pointsEntity = new Qt3DCore::QEntity( rootEntity );
 
-    pointsMesh = new Qt3DExtras::QSphereMesh( bPointEntity );
+    pointsMesh = new InstancedMarkerMesh( pointsEntity, instancedMarkers );
     pointsMesh->setRadius( .2f );
-    pointsMesh->setSlices( 20 );
-    pointsMesh->setRings( 20 );
 
-    pointsMaterial = new Qt3DExtras::QPhongMaterial( bPointEntity );
+    pointsMaterial = new InstancedMarkerMaterial( pointsEntity );
     pointsMaterial->setDiffuse( QColor( "purple" ) );
+
+    pointsEntity->addComponent( pointsMesh );
+    pointsEntity->addComponent( pointsMaterial );
+    pointsEntity->setEnabled( false );
   }
 
   {
@@ -137,26 +139,14 @@ void GlobalPlanner::createPlanPolyline( std::vector<Point_2>* polylinePtr ) {
     bPointEntity->setEnabled( false );
     widget->setToolbarToAdditionalPoint();
 
-    for( const auto& child : qAsConst( pointsEntity->children() ) ) {
-      if( auto childPtr = qobject_cast<Qt3DCore::QEntity*>( child ) ) {
-        childPtr->setEnabled( false );
-        childPtr->deleteLater();
-      }
-    }
+    QVector<QVector3D> positions;
+    positions.reserve( int( polyline->size() ) );
 
     for( const auto& point : *polyline ) {
-      auto entity = new Qt3DCore::QEntity( pointsEntity );
-
-      auto transform = new Qt3DCore::QTransform( entity );
-      transform->setTranslation( convertPoint2ToQVector3D( point ) );
-
-      entity->addComponent( pointsMaterial );
-      entity->addComponent( pointsMesh );
-      entity->addComponent( transform );
-
-      entity->setEnabled( true );
+      positions.push_back( convertPoint2ToQVector3D( point ) );
     }
 
+    pointsMesh->updatePositions( positions );
     pointsEntity->setEnabled( true );
 
     plan.resetPlanWith( make_shared<PathPrimitiveSequence>(
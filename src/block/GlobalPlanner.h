@@ -41,6 +41,8 @@
 #include "qneport.h"
 
 #include "../3d/BufferMesh.h"
+#include "../3d/InstancedMarkerMesh.h"
+#include "../3d/InstancedMarkerMaterial.h"
 
 #include "../gui/FieldsOptimitionToolbar.h"
 #include "../gui/GlobalPlannerToolbar.h"
@@ -50,7 +52,7 @@
 #include <kddockwidgets/DockWidget.h>
 
 #include "../kinematic/cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 
 #include "../kinematic/PathPrimitive.h"
 #include "../kinematic/PathPrimitiveLine.h"
@@ -76,7 +78,8 @@ class GlobalPlanner : public BlockBase {
     explicit GlobalPlanner( const QString& uniqueName,
                             MyMainWindow* mainWindow,
                             GeographicConvertionWrapper* tmw,
-                            Qt3DCore::QEntity* rootEntity );
+                            Qt3DCore::QEntity* rootEntity,
+                            bool instancedMarkers );
 
     ~GlobalPlanner() {
       dock->deleteLater();
@@ -84,15 +87,15 @@ class GlobalPlanner : public BlockBase {
     }
 
   public slots:
-    void setPose( const Point_3 position, const QQuaternion orientation, const PoseOption::Options options ) {
-      if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
-        this->position = position;
-        this->orientation = orientation;
+    void setPose( const Pose& pose ) {
+      if( !pose.options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
+        this->position = pose.position;
+        this->orientation = pose.orientation;
 
-        aPointTransform->setRotation( orientation );
-        bPointTransform->setRotation( orientation );
+        aPointTransform->setRotation( pose.orientation );
+        bPointTransform->setRotation( pose.orientation );
 
-        auto position2D = to2D( position );
+        auto position2D = to2D( pose.position );
 
         if( recordContinous ) {
           abPolyline.push_back( position2D );
@@ -105,12 +108,12 @@ class GlobalPlanner : public BlockBase {
       }
     }
 
-    void setPoseLeftEdge( const Point_3 position, const QQuaternion, const PoseOption::Options options ) {
-      if( options.testFlag( PoseOption::CalculateLocalOffsets ) &&
-          options.testFlag( PoseOption::CalculateWithoutOrientation ) ) {
-        positionLeftEdgeOfImplement = position;
+    void setPoseLeftEdge( const Pose& pose ) {
+      if( pose.options.testFlag( PoseOption::CalculateLocalOffsets ) &&
+          pose.options.testFlag( PoseOption::CalculateWithoutOrientation ) ) {
+        positionLeftEdgeOfImplement = pose.position;
 
-        auto point2D = to2D( position );
+        auto point2D = to2D( pose.position );
 
         if( implementSegment.source() != point2D ) {
           implementSegment = Segment_2( point2D, implementSegment.target() );
@@ -119,12 +122,12 @@ class GlobalPlanner : public BlockBase {
       }
     }
 
-    void setPoseRightEdge( const Point_3 position, const QQuaternion, const PoseOption::Options options ) {
-      if( options.testFlag( PoseOption::CalculateLocalOffsets ) &&
-          options.testFlag( PoseOption::CalculateWithoutOrientation ) ) {
-        positionRightEdgeOfImplement = position;
+    void setPoseRightEdge( const Pose& pose ) {
+      if( pose.options.testFlag( PoseOption::CalculateLocalOffsets ) &&
+          pose.options.testFlag( PoseOption::CalculateWithoutOrientation ) ) {
+        positionRightEdgeOfImplement = pose.position;
 
-        auto point2D = to2D( position );
+        auto point2D = to2D( pose.position );
 
         if( implementSegment.target() != point2D ) {
           implementSegment = Segment_2( implementSegment.source(), point2D );
@@ -280,9 +283,10 @@ class GlobalPlanner : public BlockBase {
     Qt3DCore::QEntity* bTextEntity = nullptr;
     Qt3DCore::QTransform* bTextTransform = nullptr;
 
+    // the points of a polyline, drawn with one instanced draw call
     Qt3DCore::QEntity* pointsEntity = nullptr;
-    Qt3DExtras::QSphereMesh* pointsMesh = nullptr;
-    Qt3DExtras::QPhongMaterial* pointsMaterial = nullptr;
+    InstancedMarkerMesh* pointsMesh = nullptr;
+    InstancedMarkerMaterial* pointsMaterial = nullptr;
 
   private:
     Qt3DCore::QEntity* m_baseEntity = nullptr;
@@ -297,13 +301,15 @@ class GlobalPlannerFactory : public BlockFactory {
                           KDDockWidgets::Location location,
                           QMenu* menu,
                           GeographicConvertionWrapper* tmw,
-                          Qt3DCore::QEntity* rootEntity )
+                          Qt3DCore::QEntity* rootEntity,
+                          bool instancedMarkers )
       : BlockFactory(),
         mainWindow( mainWindow ),
         location( location ),
         menu( menu ),
         rootEntity( rootEntity ),
-        tmw( tmw ) {
+        tmw( tmw ),
+        instancedMarkers( instancedMarkers ) {
     }
 
     QString getNameOfFactory() override {
@@ -314,7 +320,8 @@ class GlobalPlannerFactory : public BlockFactory {
       auto* object = new GlobalPlanner( getNameOfFactory() + QString::number( id ),
                                         mainWindow,
                                         tmw,
-                                        rootEntity );
+                                        rootEntity,
+                                        instancedMarkers );
       auto* b = createBaseBlock( scene, object, id, true );
 
       object->dock->setTitle( QStringLiteral( "Global Planner" ) );
@@ -324,9 +331,9 @@ class GlobalPlannerFactory : public BlockFactory {
 
       mainWindow->addDockWidget( object->dock, location );
 
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
-      b->addInputPort( QStringLiteral( "Pose Left Edge" ), QLatin1String( SLOT( setPoseLeftEdge( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
-      b->addInputPort( QStringLiteral( "Pose Right Edge" ), QLatin1String( SLOT( setPoseRightEdge( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose Left Edge" ), QLatin1String( SLOT( setPoseLeftEdge( const Pose& ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose Right Edge" ), QLatin1String( SLOT( setPoseRightEdge( const Pose& ) ) ) );
 
       b->addInputPort( QStringLiteral( "Field" ), QLatin1String( SLOT( setField( std::shared_ptr<Polygon_with_holes_2> ) ) ) );
 
@@ -341,4 +348,5 @@ class GlobalPlannerFactory : public BlockFactory {
     QMenu* menu = nullptr;
     Qt3DCore::QEntity* rootEntity = nullptr;
     GeographicConvertionWrapper* tmw = nullptr;
+    bool instancedMarkers = true;
 };
@@ -41,10 +41,13 @@
 #include "BlockBase.h"
 
 #include "../kinematic/cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 
 #include "../3d/BufferMesh.h"
+#include "../3d/GridMaterial.h"
 
+// draws a fine and a coarse grid around the vehicle, either with lines in buffers or procedurally in a
+// shader on a single quad (see GridMaterial). The buffers of the lines are only built in the line mode
 class GridModel : public BlockBase {
     Q_OBJECT
 
@@ -76,6 +79,18 @@ class GridModel : public BlockBase {
       m_fineGridEntity->addComponent( m_material );
       m_coarseGridEntity->addComponent( m_materialCoarse );
 
+      m_proceduralGridEntity = new Qt3DCore::QEntity( m_baseEntity );
+      m_proceduralGridMesh = new Qt3DExtras::QPlaneMesh( m_proceduralGridEntity );
+      m_proceduralGridTransform = new Qt3DCore::QTransform( m_proceduralGridEntity );
+      // QPlaneMesh is in the xz-plane
+      m_proceduralGridTransform->setRotation( QQuaternion::fromAxisAndAngle( QVector3D( 1, 0, 0 ), 90 ) );
+      m_proceduralGridTransform->setTranslation( QVector3D( 0, 0, -0.05f ) );
+      m_proceduralGridMaterial = new GridMaterial( m_proceduralGridEntity );
+      m_proceduralGridEntity->addComponent( m_proceduralGridMesh );
+      m_proceduralGridEntity->addComponent( m_proceduralGridTransform );
+      m_proceduralGridEntity->addComponent( m_proceduralGridMaterial );
+      m_proceduralGridEntity->setEnabled( false );
+
       QObject::connect( m_lod, &Qt3DRender::QLevelOfDetail::currentIndexChanged, this, &GridModel::currentIndexChanged );
     }
 
@@ -90,7 +105,9 @@ class GridModel : public BlockBase {
       m_lod->setEnabled( false );
       m_distanceMeasurementTransform->setEnabled( false );
       m_distanceMeasurementEntity->setEnabled( false );
+      m_proceduralGridEntity->setEnabled( false );
 
+      m_proceduralGridEntity->deleteLater();
       m_fineLinesMesh->deleteLater();
       m_coarseLinesMesh->deleteLater();
       m_material->deleteLater();
@@ -104,12 +121,12 @@ class GridModel : public BlockBase {
     }
 
   public slots:
-    void setPose( const Point_3 position, QQuaternion, PoseOption::Options ) {
-      m_distanceMeasurementTransform->setTranslation( convertPoint3ToQVector3D( position ) );
+    void setPose( const Pose& pose ) {
+      m_distanceMeasurementTransform->setTranslation( convertPoint3ToQVector3D( pose.position ) );
 
-      QVector3D positionModulo( float( std::floor( ( position.x() ) / xStepMax ) * xStepMax ),
-                                float( std::floor( ( position.y() ) / yStepMax ) * yStepMax ),
-                                float( position.z() ) );
+      QVector3D positionModulo( float( std::floor( ( pose.position.x() ) / xStepMax ) * xStepMax ),
+                                float( std::floor( ( pose.position.y() ) / yStepMax ) * yStepMax ),
+                                float( pose.position.z() ) );
       m_baseTransform->setTranslation( positionModulo );
     }
 
@@ -117,6 +134,19 @@ class GridModel : public BlockBase {
       m_baseEntity->setEnabled( enabled );
     }
 
+    void setGridProcedural( bool procedural ) {
+      if( this->procedural != procedural ) {
+        this->procedural = procedural;
+
+        if( !procedural && linesDirty ) {
+          updateLines();
+        }
+
+        m_proceduralGridEntity->setEnabled( procedural );
+        currentIndexChanged( m_lod->currentIndex() );
+      }
+    }
+
     void setGridValues( float xStep, float yStep, float xStepCoarse, float yStepCoarse, float size, float cameraThreshold, float cameraThresholdCoarse, QColor color, QColor colorCoarse ) {
       this->xStep = double( xStep );
       this->yStep = double( yStep );
@@ -124,10 +154,66 @@ class GridModel : public BlockBase {
       this->yStepCoarse = double( yStepCoarse );
       this->xStepMax = double( std::max( xStep, xStepCoarse ) );
       this->yStepMax = double( std::max( yStep, yStepCoarse ) );
+      this->size = size;
 
       QVector<qreal> thresholds = {qreal( cameraThreshold ), qreal( cameraThresholdCoarse ), 10000};
       m_lod->setThresholds( thresholds );
 
+      m_material->setAmbient( color );
+      m_materialCoarse->setAmbient( colorCoarse );
+
+      // the procedural grid only needs its parameters; the quad is as big as the grid
+      m_proceduralGridMesh->setWidth( size );
+      m_proceduralGridMesh->setHeight( size );
+      m_proceduralGridMaterial->setSteps( QVector2D( xStep, yStep ), QVector2D( xStepCoarse, yStepCoarse ) );
+      m_proceduralGridMaterial->setCameraThresholds( cameraThreshold, cameraThresholdCoarse );
+      m_proceduralGridMaterial->setColors( color, colorCoarse );
+
+      if( procedural ) {
+        linesDirty = true;
+      } else {
+        updateLines();
+      }
+    }
+
+    void  currentIndexChanged( int currentIndex ) {
+      // the procedural grid fades the lines in the shader
+      if( procedural ) {
+        m_fineGridEntity->setEnabled( false );
+        m_coarseGridEntity->setEnabled( false );
+        return;
+      }
+
+      switch( currentIndex ) {
+        case 0: {
+          m_fineGridEntity->setEnabled( true );
+          m_coarseGridEntity->setEnabled( true );
+        }
+        break;
+
+        case 1: {
+          m_fineGridEntity->setEnabled( false );
+          m_coarseGridEntity->setEnabled( true );
+        }
+        break;
+
+        default: {
+          m_fineGridEntity->setEnabled( false );
+          m_coarseGridEntity->setEnabled( false );
+        }
+      }
+
+    }
+
+  signals:
+
+  private:
+    void updateLines() {
+      const float xStep = float( this->xStep );
+      const float yStep = float( this->yStep );
+      const float xStepCoarse = float( this->xStepCoarse );
+      const float yStepCoarse = float( this->yStepCoarse );
+
       // fine
       {
         QVector<QVector3D> linesPoints;
@@ -214,34 +300,9 @@ class GridModel : public BlockBase {
         m_coarseLinesMesh->bufferUpdate( linesPoints );
       }
 
-      m_material->setAmbient( color );
-      m_materialCoarse->setAmbient( colorCoarse );
-    }
-
-    void  currentIndexChanged( int currentIndex ) {
-      switch( currentIndex ) {
-        case 0: {
-          m_fineGridEntity->setEnabled( true );
-          m_coarseGridEntity->setEnabled( true );
-        }
-        break;
-
-        case 1: {
-          m_fineGridEntity->setEnabled( false );
-          m_coarseGridEntity->setEnabled( true );
-        }
-        break;
-
-        default: {
-          m_fineGridEntity->setEnabled( false );
-          m_coarseGridEntity->setEnabled( false );
-        }
-      }
-
+      linesDirty = false;
     }
 
-  signals:
-
   private:
     Qt3DCore::QEntity* m_distanceMeasurementEntity = nullptr;
     Qt3DCore::QTransform* m_distanceMeasurementTransform = nullptr;
@@ -257,12 +318,21 @@ class GridModel : public BlockBase {
     Qt3DExtras::QPhongMaterial* m_material = nullptr;
     Qt3DExtras::QPhongMaterial* m_materialCoarse = nullptr;
 
+    Qt3DCore::QEntity* m_proceduralGridEntity = nullptr;
+    Qt3DExtras::QPlaneMesh* m_proceduralGridMesh = nullptr;
+    Qt3DCore::QTransform* m_proceduralGridTransform = nullptr;
+    GridMaterial* m_proceduralGridMaterial = nullptr;
+
     double xStep = 1;
     double yStep = 1;
     double xStepCoarse = 10;
     double yStepCoarse = 10;
     double xStepMax = 1;
     double yStepMax = 1;
+    float size = 10;
+
+    bool procedural = false;
+    bool linesDirty = true;
 };
 
 class GridModelFactory : public BlockFactory {
@@ -281,7 +351,7 @@ class GridModelFactory : public BlockFactory {
       auto* obj = new GridModel( rootEntity, m_cameraEntity );
       auto* b = createBaseBlock( scene, obj, id, true );
 
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
 
       return b;
     }
@@ -34,7 +34,7 @@
 
 #include "ImplementSection.h"
 
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 
 #include "../gui/MyMainWindow.h"
 
@@ -75,11 +75,11 @@ class Implement : public BlockBase {
 
       emit leftEdgeChanged( QVector3D( 0, float( -width / 2 ), 0 ) );
       emit rightEdgeChanged( QVector3D( 0, float( width / 2 ), 0 ) );
-      emit triggerLocalPose( Point_3( 0, 0, 0 ),
-                             QQuaternion(),
-                             PoseOption::CalculateLocalOffsets |
-                             PoseOption::CalculateWithoutOrientation |
-                             PoseOption::CalculateFromPivotPoint );
+      emit triggerLocalPose( Pose( Point_3( 0, 0, 0 ),
+                                   QQuaternion(),
+                                   PoseOption::CalculateLocalOffsets |
+                                   PoseOption::CalculateWithoutOrientation |
+                                   PoseOption::CalculateFromPivotPoint ) );
       emit implementChanged( this );
     }
 
@@ -129,7 +129,7 @@ class Implement : public BlockBase {
     }
 
   signals:
-    void triggerLocalPose( const Point_3, const QQuaternion, const PoseOption::Options );
+    void triggerLocalPose( const Pose& );
     void leftEdgeChanged( QVector3D );
     void rightEdgeChanged( QVector3D );
     void implementChanged( const QPointer<Implement> );
@@ -191,7 +191,7 @@ class ImplementFactory : public BlockFactory {
         mainWindow->addDockWidget( object->dock, KDDockWidgets::Location_OnBottom, firstDock );
       }
 
-      b->addOutputPort( QStringLiteral( "Trigger Calculation of Local Pose" ), QLatin1String( SIGNAL( triggerLocalPose( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addOutputPort( QStringLiteral( "Trigger Calculation of Local Pose" ), QLatin1String( SIGNAL( triggerLocalPose( const Pose& ) ) ) );
       b->addOutputPort( QStringLiteral( "Implement Data" ), QLatin1String( SIGNAL( implementChanged( const QPointer<Implement> ) ) ) );
       b->addOutputPort( QStringLiteral( "Section Control Data" ), QLatin1String( SIGNAL( sectionsChanged() ) ) );
       b->addOutputPort( QStringLiteral( "Position Left Edge" ), QLatin1String( SIGNAL( leftEdgeChanged( QVector3D ) ) ) );
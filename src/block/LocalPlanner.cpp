@@ -28,12 +28,12 @@
 
 #include <dubins/dubins.h>
 
-void LocalPlanner::setPose( const Point_3 position, QQuaternion orientation, PoseOption::Options options ) {
-  if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
-    this->position = position;
-    this->orientation = orientation;
+void LocalPlanner::setPose( const Pose& pose ) {
+  if( !pose.options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
+    this->position = pose.position;
+    this->orientation = pose.orientation;
 
-    const Point_2 position2D = to2D( position );
+    const Point_2 position2D = to2D( pose.position );
 
     if( !turningLeft && !turningRight ) {
       if( !globalPlan.plan->empty() ) {
@@ -50,7 +50,7 @@ void LocalPlanner::setPose( const Point_3 position, QQuaternion orientation, Pos
 
         if( lastPrimitive->anyDirection ) {
           double angleLastPrimitiveDegrees = lastPrimitive->angleAtPointDegrees( position2D );
-          double steerAngleAbsoluteDegrees = steeringAngleDegrees + orientation.toEulerAngles().z();
+          double steerAngleAbsoluteDegrees = steeringAngleDegrees + pose.orientation.toEulerAngles().z();
 
           if( std::abs( std::abs( steerAngleAbsoluteDegrees ) - std::abs( angleLastPrimitiveDegrees ) ) > 95 ) {
             auto reverse = lastPrimitive->createReverse();
@@ -76,7 +76,7 @@ void LocalPlanner::setPose( const Point_3 position, QQuaternion orientation, Pos
           turningRight = false;
           emit resetTurningStateOfDock();
 
-          setPose( position, orientation, options );
+          setPose( pose );
         }
       }
     }
@@ -158,7 +158,7 @@ void LocalPlanner::calculateTurning( bool changeExistingTurn ) {
       offset = -offset;
     }
 
-    emit triggerPlanPose( to3D( positionTurnStart + offset ), orientation, PoseOption::Options() );
+    emit triggerPlanPose( Pose( to3D( positionTurnStart + offset ), orientation, PoseOption::NoOptions ) );
 
     nearestPrimitive = globalPlan.getNearestPrimitive( positionTurnStart, distanceSquared );
 
@@ -31,7 +31,7 @@
 #include "BlockBase.h"
 #include "ValueDockBlockBase.h"
 
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 
 class OrientationDockBlock : public ValueDockBlockBase {
     Q_OBJECT
@@ -103,8 +103,8 @@ class OrientationDockBlock : public ValueDockBlockBase {
       widget->setValues( eulerAngles.y(), eulerAngles.x(), eulerAngles.z() );
     }
 
-    void setPose( const Point_3&, const QQuaternion orientation, const PoseOption::Options ) {
-      setOrientation( orientation );
+    void setPose( const Pose& pose ) {
+      setOrientation( pose.orientation );
     }
 
   public:
@@ -149,7 +149,7 @@ class OrientationDockBlockFactory : public BlockFactory {
       }
 
       b->addInputPort( QStringLiteral( "Orientation" ), QLatin1String( SLOT( setOrientation( QQuaternion ) ) ) );
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
 
       b->setBrush( dockColor );
 
@@ -46,7 +46,7 @@
 
 
 #include "../kinematic/cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 
 #include "../kinematic/Plan.h"
 
@@ -124,15 +124,15 @@ void PathPlannerModel::refreshColors() {
   bisectorsMaterial->setAmbient( bisectorsColor );
 }
 
-void PathPlannerModel::setPose( const Point_3 position, const QQuaternion orientation, const PoseOption::Options options ) {
-  if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
-    this->position = position;
-    this->orientation = orientation;
+void PathPlannerModel::setPose( const Pose& pose ) {
+  if( !pose.options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
+    this->position = pose.position;
+    this->orientation = pose.orientation;
 
     if( visible ) {
 
       if( !plan.plan->empty() ) {
-        const Point_2 position2D = to2D( position );
+        const Point_2 position2D = to2D( pose.position );
 
         Iso_rectangle_2 viewBoxRect( Bbox_2( position2D.x() - viewBox, position2D.y() - viewBox, position2D.x() + viewBox, position2D.y() + viewBox ) );
 
@@ -45,7 +45,7 @@
 #include "qneport.h"
 
 #include "../kinematic/cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 #include "../kinematic/PathPrimitive.h"
 #include "../kinematic/Plan.h"
 
@@ -104,7 +104,7 @@ class PathPlannerModel : public BlockBase {
       this->plan = plan;
     }
 
-    void setPose( const Point_3 position, const QQuaternion orientation, const PoseOption::Options options );
+    void setPose( const Pose& );
 
   public:
     Point_3 position = Point_3( 0, 0, 0 );
@@ -160,7 +160,7 @@ class PathPlannerModelFactory : public BlockFactory {
       auto* obj = new PathPlannerModel( rootEntity );
       auto* b = createBaseBlock( scene, obj, id );
 
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
       b->addInputPort( QStringLiteral( "Plan" ), QLatin1String( SLOT( setPlan( const Plan& ) ) ) );
 
       b->setBrush( modelColor );
@@ -29,7 +29,7 @@
 #include "qneport.h"
 
 #include "../kinematic/cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 
 class PoseSynchroniser : public BlockBase {
     Q_OBJECT
@@ -43,7 +43,7 @@ class PoseSynchroniser : public BlockBase {
       this->position = position;
       QElapsedTimer timer;
       timer.start();
-      emit poseChanged( this->position, orientation, PoseOption::NoOptions );
+      emit poseChanged( Pose::now( this->position, orientation, PoseOption::NoOptions, ++sequenceNumber ) );
 //      qDebug() << "Cycle Time PoseSynchroniser:  " << timer.nsecsElapsed() << "ns";
     }
 
@@ -52,16 +52,17 @@ class PoseSynchroniser : public BlockBase {
     }
 
   signals:
-    void poseChanged( const Point_3, const QQuaternion, const PoseOption::Options );
+    void poseChanged( const Pose& );
 
   public:
     virtual void emitConfigSignals() override {
-      emit poseChanged( position, orientation, PoseOption::NoOptions );
+      emit poseChanged( Pose::now( position, orientation, PoseOption::NoOptions, sequenceNumber ) );
     }
 
   public:
     Point_3 position = Point_3( 0, 0, 0 );
     QQuaternion orientation = QQuaternion();
+    quint32 sequenceNumber = 0;
 };
 
 class PoseSynchroniserFactory : public BlockFactory {
@@ -82,7 +83,7 @@ class PoseSynchroniserFactory : public BlockFactory {
       b->addInputPort( QStringLiteral( "Position" ), QLatin1String( SLOT( setPosition( const Point_3& ) ) ) );
       b->addInputPort( QStringLiteral( "Orientation" ), QLatin1String( SLOT( setOrientation( const QQuaternion ) ) ) );
 
-      b->addOutputPort( QStringLiteral( "Pose" ), QLatin1String( SIGNAL( poseChanged( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addOutputPort( QStringLiteral( "Pose" ), QLatin1String( SIGNAL( poseChanged( const Pose& ) ) ) );
 
       return b;
     }
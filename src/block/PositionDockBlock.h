@@ -31,7 +31,7 @@
 #include "BlockBase.h"
 #include "ValueDockBlockBase.h"
 
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 
 class PositionDockBlock : public ValueDockBlockBase {
     Q_OBJECT
@@ -97,12 +97,12 @@ class PositionDockBlock : public ValueDockBlockBase {
       dock->toggleAction()->setText( QStringLiteral( "Position: " ) + name );
     }
 
-    void setPose( const Point_3& point, const QQuaternion, const PoseOption::Options ) {
+    void setPose( const Pose& pose ) {
       if( wgs84 ) {
         widget->setDescriptions( QStringLiteral( "X" ), QStringLiteral( "Y" ), QStringLiteral( "Z" ) );
       }
 
-      widget->setValues( point.x(), point.y(), point.z() );
+      widget->setValues( pose.position.x(), pose.position.y(), pose.position.z() );
     }
 
     void setWGS84Position( double lat, double lon, double height ) {
@@ -157,7 +157,7 @@ class PositionDockBlockFactory : public BlockFactory {
       }
 
       b->addInputPort( QStringLiteral( "WGS84 Position" ), QLatin1String( SLOT( setWGS84Position( const double, const double, const double ) ) ) );
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
 
       b->setBrush( dockColor );
 
@@ -21,81 +21,117 @@
 #include <QtCore/QDebug>
 #include <QtMath>
 
-#include "../3d/texturerendertarget.h"
-#include <Qt3DRender/QRenderSurfaceSelector>
-#include <Qt3DRender/QRenderTargetSelector>
-#include <Qt3DRender/QClearBuffers>
-#include <Qt3DRender/QViewport>
-#include <Qt3DRender/QCameraSelector>
-#include <Qt3DRender/QFrustumCulling>
-#include <Qt3DRender/QRenderCapture>
-#include <Qt3DRender/QRenderCaptureReply>
+#include <algorithm>
+#include <cmath>
+
+constexpr double SectionControl::maxDistanceBetweenPoses;
+constexpr double SectionControl::lookAheadDistance;
+constexpr double SectionControl::maxCoverage;
+constexpr double SectionControl::distanceOfTilesInMemory;
+constexpr double SectionControl::filterFactor;
+constexpr int SectionControl::pointsInFieldToCheck;
 
 SectionControl::SectionControl( const QString& uniqueName,
                                 MyMainWindow* mainWindow,
-                                Qt3DCore::QEntity* rootEntity,
-                                Qt3DRender::QFrameGraphNode* frameGraphParent )
-  : frameGraphParent( frameGraphParent ) {
-
+                                GeographicConvertionWrapper* tmw )
+  : tmw( tmw ) {
   label = new QLabel( mainWindow );
   label->setScaledContents( true );
 
   dock = new KDDockWidgets::DockWidget( uniqueName );
   dock->setWidget( label );
 
-  cameraEntity = new Qt3DRender::QCamera( rootEntity );
-  cameraEntity->setProjectionType( Qt3DRender::QCameraLens::OrthographicProjection );
-  cameraEntity->lens()->setOrthographicProjection( 10, -10, 10, -10, 0.1f, 30 );
-  cameraEntity->setPosition( QVector3D( 0, 0, 20.0f ) );
-  cameraEntity->setUpVector( QVector3D( 0, 1, 0 ) );
-  cameraEntity->setViewCenter( QVector3D( 0, 0, 0 ) );
-
-  // Create a texture to render into. This acts as the buffer that
-  // holds the rendered image.
-  auto renderTargetSelector = new Qt3DRender::QRenderTargetSelector( frameGraphParent );
-  auto textureTarget = new TextureRenderTarget( renderTargetSelector, QSize( 1, 400 ) );
-  renderTargetSelector->setTarget( textureTarget );
-
-  // Create a viewport node. The viewport here just covers the entire render area.
-  auto viewport = new Qt3DRender::QViewport( renderTargetSelector );
-  viewport->setNormalizedRect( QRectF( 0.0, 0.0, 1.0, 1.0 ) );
-
-  // Create a camera selector node, and tell it to use the camera we've ben given.
-  auto cameraSelector = new Qt3DRender::QCameraSelector( viewport );
-  cameraSelector->setCamera( cameraEntity );
-
-  // Create a node used for clearing the required buffers.
-  auto clearBuffers = new Qt3DRender::QClearBuffers( cameraSelector );
-  clearBuffers->setClearColor( QColor( 0, 0, 0, 255 ) );
-  clearBuffers->setBuffers( Qt3DRender::QClearBuffers::ColorDepthBuffer );
+  image = QImage( 400, 1, QImage::Format_Grayscale8 );
+  image.fill( 0 );
 
-  layerFilter = new Qt3DRender::QLayerFilter( clearBuffers );
-  layerFilter->setFilterMode( Qt3DRender::QLayerFilter::AcceptAnyMatchingLayers );
-
-  auto frustumCulling = new Qt3DRender::QFrustumCulling( layerFilter );
-
-  renderCapture = new Qt3DRender::QRenderCapture( frustumCulling );
-
-  frameGraph = renderTargetSelector;
-
-  requestRenderCapture();
+  timeSinceFlush.start();
 }
 
-// order is important! Crashes if a parent entity is removed first!
 SectionControl::~SectionControl() {
-  frameGraph->deleteLater();
-  reply->deleteLater();
   label->deleteLater();
   dock->deleteLater();
 }
 
-void SectionControl::setPose( const Point_3 position, const QQuaternion orientation, const PoseOption::Options options ) {
-  if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
-    if( implement != nullptr ) {
-      auto transform = cameraEntity->transform();
-
-      transform->setTranslation( convertPoint3ToQVector3D( position ) + QVector3D( 0, 0, 20 ) );
-      transform->setRotation( orientation );
+void SectionControl::setPose( const Pose& pose ) {
+  if( !pose.options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
+    if( implement != nullptr && !sectionOffsets.empty() ) {
+      const std::size_t numSections = sectionOffsets.size() / 2;
+      const Point_2 position2D = to2D( pose.position );
+
+      std::vector<Point_2> edges;
+      edges.reserve( sectionOffsets.size() );
+
+      for( const auto offset : sectionOffsets ) {
+        const QVector3D positionCorrection = pose.orientation * QVector3D( 0, float( offset ), 0 );
+        edges.emplace_back( position2D.x() + double( positionCorrection.x() ),
+                            position2D.y() + double( positionCorrection.y() ) );
+      }
+
+      const QVector3D heading3D = pose.orientation * QVector3D( 1, 0, 0 );
+      const Vector_2 heading( double( heading3D.x() ), double( heading3D.y() ) );
+
+      updateSwitchTimes( pose.timestamp );
+
+      // the origin of the local coordinates changed: the map is reprojected and the last edges are in the old one
+      if( coverageMap.followOrigin() ) {
+        lastEdgesValid = false;
+      }
+
+      const bool continuous = lastEdgesValid &&
+                              CGAL::squared_distance( lastPosition, position2D ) < ( maxDistanceBetweenPoses * maxDistanceBetweenPoses );
+
+      // estimate the speed and the yaw rate for the prediction of the edges
+      const double deltaT = double( pose.timestamp - lastTimestamp ) / 1000;
+
+      if( continuous && deltaT > 0 && deltaT < 1 ) {
+        const Vector_2 movement = position2D - lastPosition;
+        const double speed = std::sqrt( movement.squared_length() ) / deltaT;
+        const double turned = normalizeAngleRadians( std::atan2( heading.y(), heading.x() ) -
+                              std::atan2( lastHeading.y(), lastHeading.x() ) );
+
+        velocity += ( std::copysign( speed, movement * heading ) - velocity ) * filterFactor;
+        yawRate += ( turned / deltaT - yawRate ) * filterFactor;
+      } else if( !continuous ) {
+        velocity = 0;
+        yawRate = 0;
+      }
+
+      // add the strips of the sections, which are working
+      if( continuous ) {
+        bool worked = false;
+
+        for( std::size_t i = 0; i < numSections; ++i ) {
+          if( isSectionWorking( i, pose.timestamp ) ) {
+            const auto counts = coverageMap.addStrip( lastEdges[i * 2], lastEdges[i * 2 + 1], edges[i * 2], edges[i * 2 + 1] );
+
+            overlapCells += counts.coveredCells;
+            cellsOfSections[i] += counts.newCells + counts.coveredCells;
+            worked = true;
+          }
+        }
+
+        if( worked ) {
+          emitAreas();
+        }
+      }
+
+      lastEdges.swap( edges );
+      lastPosition = position2D;
+      lastHeading = heading;
+      lastTimestamp = pose.timestamp;
+      lastEdgesValid = true;
+
+      updateAutomaticStates();
+      updateSwitchTimes( pose.timestamp );
+
+      if( timeSinceFlush.hasExpired( flushInterval ) ) {
+        coverageMap.unloadTilesFarFrom( position2D, distanceOfTilesInMemory );
+        timeSinceFlush.restart();
+      }
+
+      if( label->isVisible() ) {
+        updateImage();
+      }
     }
   }
 }
@@ -127,58 +163,251 @@ void SectionControl::setImplement( const QPointer<Implement>& implement ) {
       sectionOffset += section->overlapRight;
     }
 
-    cameraEntity->lens()->setOrthographicProjection( 0.1f, 0, float( sectionOffsets.front() ), float( sectionOffsets.back() ),  0.1f, 1000 );
+    if( cellsOfSections.size() != numSections - 1 ) {
+      cellsOfSections.assign( numSections - 1, 0 );
+    }
+
+    sectionsCommandedOn.assign( numSections - 1, false );
+    timesOfSwitch.assign( numSections - 1, 0 );
 
+    lastEdgesValid = false;
   }
 }
 
 void SectionControl::setSections() {
-  if( implement != nullptr ) {
-//    size_t numSections = implement->sections.size();
+  updateAutomaticStates();
+}
+
+void SectionControl::setField( std::shared_ptr<Polygon_with_holes_2> field ) {
+  this->field = field;
+
+  if( field != nullptr ) {
+    bboxOfField = field->outer_boundary().bbox();
+  }
+
+  updateAutomaticStates();
+}
+
+void SectionControl::setSwitchOnLatency( double latency ) {
+  switchOnLatency = std::max( 0.0, latency );
+}
+
+void SectionControl::setSwitchOffLatency( double latency ) {
+  switchOffLatency = std::max( 0.0, latency );
+}
 
-//    const auto& section0 = implement->sections.at( 0 );
-//    const auto& state0 = section0->state();
-//    const bool globalForceOff = state0.testFlag( ImplementSection::State::ForceOff );
-//    const bool globalForceOn = state0.testFlag( ImplementSection::State::ForceOn );
+void SectionControl::setCoverageFile( const QString& fileName ) {
+  coverageMap.setFile( fileName, tmw );
 
-//    for( size_t i = 1; i < numSections; ++i ) {
-//      size_t sectionIndex = i - 1;
-//      const auto& section = implement->sections.at( i );
-//      const auto& state = section->state();
+  // the last edges might be in another origin now
+  lastEdgesValid = false;
+  updateAutomaticStates();
 
-//      if( !globalForceOff &&
-//          ( !state.testFlag( ImplementSection::State::ForceOff ) ) &&
-//          ( globalForceOn || section->isSectionOn() ) ) {
-//        if( sectionMeshes.at( sectionIndex ) == nullptr ) {
-//          sectionMeshes.at( sectionIndex ) = createNewMesh();
-//        }
-//      } else {
-//        if( sectionMeshes.at( sectionIndex ) != nullptr ) {
-//          sectionMeshes.at( sectionIndex )->optimise( threadForCgalWorker );
-//          sectionMeshes.at( sectionIndex ) = nullptr;
-//        }
-//      }
-//    }
+  emitAreas();
+}
+
+void SectionControl::setSectionOfArea( double number ) {
+  sectionOfArea = std::size_t( std::max( 1.0, number ) );
+  emitAreas();
+}
+
+void SectionControl::emitConfigSignals() {
+  emitAreas();
+}
+
+void SectionControl::emitAreas() {
+  constexpr double squareMetersPerHectare = 10000;
+
+  const std::size_t workedCells = coverageMap.numCoveredCells();
+  std::size_t cellsOfAllSections = 0;
+
+  for( const auto cells : cellsOfSections ) {
+    cellsOfAllSections += cells;
   }
+
+  emit workedAreaChanged( CoverageMap::areaOfCells( workedCells ) / squareMetersPerHectare );
+  emit overlapAreaChanged( CoverageMap::areaOfCells( overlapCells ) / squareMetersPerHectare );
+  emit overlapChanged( cellsOfAllSections > 0 ? double( overlapCells ) * 100 / double( cellsOfAllSections ) : 0 );
+  emit areaOfSectionChanged( sectionOfArea <= cellsOfSections.size() ?
+                             CoverageMap::areaOfCells( cellsOfSections[sectionOfArea - 1] ) / squareMetersPerHectare : 0 );
 }
 
-void SectionControl::setLayer( Qt3DRender::QLayer* layer ) {
-  layerFilter->addLayer( layer );
+bool SectionControl::isSectionOn( std::size_t sectionIndex ) {
+  const auto& state0 = implement->sections.at( 0 )->state();
+  const bool globalForceOff = state0.testFlag( ImplementSection::State::ForceOff );
+  const bool globalForceOn = state0.testFlag( ImplementSection::State::ForceOn );
+
+  const auto& section = implement->sections.at( sectionIndex );
+
+  return !globalForceOff &&
+         ( !section->state().testFlag( ImplementSection::State::ForceOff ) ) &&
+         ( globalForceOn || section->isSectionOn() );
 }
 
-void SectionControl::onImageRendered() {
-  // Get the image from the reply and display it in the label.
-  label->setPixmap( QPixmap::fromImage( reply->image() ) );
+void SectionControl::updateAutomaticStates() {
+  if( implement == nullptr || !lastEdgesValid || ( sectionOffsets.size() / 2 ) + 1 != implement->sections.size() ) {
+    return;
+  }
+
+  const bool automatic = implement->sections.at( 0 )->state().testFlag( ImplementSection::State::Automatic );
+
+  // a section, which is off, is checked where it will be when it starts working, one which is on where it
+  // will stop. So the implement switches on/off exactly at the edge of the worked area or the boundary
+  std::vector<Point_2> edgesOn;
+  std::vector<Point_2> edgesOff;
+
+  if( automatic ) {
+    predictEdges( switchOnLatency, edgesOn );
+    predictEdges( switchOffLatency, edgesOff );
+  }
+
+  bool changed = false;
+
+  for( std::size_t i = 1, end = implement->sections.size(); i < end; ++i ) {
+    const auto& section = implement->sections.at( i );
+    const auto oldState = section->state();
+
+    if( automatic ) {
+      const bool isOn = section->state().testFlag( ImplementSection::State::AutomaticOn );
+      const auto& edges = isOn ? edgesOff : edgesOn;
+      const bool on = coverageOfSegment( edges[( i - 1 ) * 2], edges[( i - 1 ) * 2 + 1] ) <= maxCoverage;
+
+      section->addState( ImplementSection::State::Automatic );
+      section->setState( ImplementSection::State::AutomaticOn, on );
+      section->setState( ImplementSection::State::AutomaticOff, !on );
+    } else {
+      section->removeState( ImplementSection::State::Automatic |
+                            ImplementSection::State::AutomaticOn |
+                            ImplementSection::State::AutomaticOff );
+    }
+
+    changed |= ( oldState != section->state() );
+  }
 
-  // Request another render capture.
-  requestRenderCapture();
+  // only emit on changes, as setSections() is called for every emit
+  if( changed ) {
+    implement->emitSectionsChanged();
+  }
+}
+
+void SectionControl::updateSwitchTimes( qint64 timestamp ) {
+  if( implement == nullptr || ( sectionsCommandedOn.size() + 1 ) != implement->sections.size() ) {
+    return;
+  }
+
+  for( std::size_t i = 0, end = sectionsCommandedOn.size(); i < end; ++i ) {
+    const bool on = isSectionOn( i + 1 );
+
+    if( on != sectionsCommandedOn[i] ) {
+      sectionsCommandedOn[i] = on;
+      timesOfSwitch[i] = timestamp;
+    }
+  }
+}
+
+bool SectionControl::isSectionWorking( std::size_t sectionIndex, qint64 timestamp ) {
+  if( sectionIndex >= sectionsCommandedOn.size() ) {
+    return false;
+  }
+
+  // without timestamps, the delays can't be known
+  if( timestamp == 0 ) {
+    return sectionsCommandedOn[sectionIndex];
+  }
+
+  const double sinceSwitch = double( timestamp - timesOfSwitch[sectionIndex] ) / 1000;
+
+  if( sectionsCommandedOn[sectionIndex] ) {
+    return sinceSwitch >= switchOnLatency;
+  }
+
+  return sinceSwitch < switchOffLatency;
+}
+
+void SectionControl::predictEdges( double latency, std::vector<Point_2>& edges ) {
+  const double heading = std::atan2( lastHeading.y(), lastHeading.x() );
+  const double turned = yawRate * latency;
+  const double predictedHeading = heading + turned;
+
+  // along an arc with the current speed and yaw rate; a straight line if not turning
+  Vector_2 movement;
+
+  if( std::abs( turned ) < 1e-6 ) {
+    movement = lastHeading * ( velocity * latency );
+  } else {
+    const double radius = velocity / yawRate;
+    movement = Vector_2( radius * ( std::sin( predictedHeading ) - std::sin( heading ) ),
+                         radius * ( std::cos( heading ) - std::cos( predictedHeading ) ) );
+  }
+
+  const Point_2 position = lastPosition + movement;
+  const Vector_2 lookAhead = Vector_2( std::cos( predictedHeading ), std::sin( predictedHeading ) ) * lookAheadDistance;
+  const double cosTurned = std::cos( turned );
+  const double sinTurned = std::sin( turned );
+
+  edges.clear();
+  edges.reserve( lastEdges.size() );
+
+  // the edges are rotated around the position, so a roll of the implement is kept
+  for( const auto& edge : lastEdges ) {
+    const Vector_2 offset = edge - lastPosition;
+    edges.push_back( position + lookAhead +
+                     Vector_2( offset.x() * cosTurned - offset.y() * sinTurned,
+                               offset.x() * sinTurned + offset.y() * cosTurned ) );
+  }
+}
+
+double SectionControl::coverageOfSegment( const Point_2& from, const Point_2& to ) {
+  double coverage = coverageMap.coverageOfSegment( from, to );
+
+  if( field != nullptr ) {
+    int outside = 0;
+
+    for( int i = 0; i < pointsInFieldToCheck; ++i ) {
+      const double t = double( i ) / ( pointsInFieldToCheck - 1 );
+
+      if( !isInField( from + ( to - from ) * t ) ) {
+        ++outside;
+      }
+    }
+
+    coverage = std::max( coverage, double( outside ) / pointsInFieldToCheck );
+  }
+
+  return coverage;
 }
 
-void SectionControl::requestRenderCapture() {
-  if( reply != nullptr ) {
-    reply->deleteLater();
+bool SectionControl::isInField( const Point_2& point ) {
+  if( point.x() < bboxOfField.xmin() || point.x() > bboxOfField.xmax() ||
+      point.y() < bboxOfField.ymin() || point.y() > bboxOfField.ymax() ) {
+    return false;
+  }
+
+  if( field->outer_boundary().bounded_side( point ) == CGAL::ON_UNBOUNDED_SIDE ) {
+    return false;
+  }
+
+  for( auto hole = field->holes_begin(); hole != field->holes_end(); ++hole ) {
+    if( hole->bounded_side( point ) == CGAL::ON_BOUNDED_SIDE ) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void SectionControl::updateImage() {
+  // the coverage along the implement, ahead of it
+  const Vector_2 lookAhead = lastHeading * lookAheadDistance;
+  const Point_2 left = lastEdges.front() + lookAhead;
+  const Point_2 right = lastEdges.back() + lookAhead;
+
+  uchar* pixels = image.scanLine( 0 );
+
+  for( int i = 0, width = image.width(); i < width; ++i ) {
+    const double t = ( double( i ) + 0.5 ) / width;
+    pixels[i] = coverageMap.isCovered( left + ( right - left ) * t ) ? 255 : 0;
   }
 
-  reply = renderCapture->requestCapture();
-  QObject::connect( reply, &Qt3DRender::QRenderCaptureReply::completed, this, &SectionControl::onImageRendered );
+  label->setPixmap( QPixmap::fromImage( image ) );
 }
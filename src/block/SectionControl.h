@@ -19,66 +19,134 @@
 #pragma once
 
 #include <QObject>
-
-#include <Qt3DCore/QEntity>
-#include <Qt3DCore/QTransform>
-
-#include "../3d/texturerendertarget.h"
-#include <Qt3DRender/QLayer>
-#include <Qt3DRender/QFrameGraphNode>
-#include <Qt3DRender/QLayerFilter>
-#include <Qt3DRender/QCamera>
-#include <Qt3DRender/QRenderCapture>
-#include <Qt3DRender/QRenderCaptureReply>
+#include <QImage>
+#include <QElapsedTimer>
 
 #include "BlockBase.h"
 
 #include "../kinematic/cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
+#include "../kinematic/CoverageMap.h"
 
 #include "../block/Implement.h"
 
+class GeographicConvertionWrapper;
+
+// switches the sections in the automatic mode off over already worked ground. The worked area is
+// kept in a CoverageMap, which gets the strips of the sections that are on with every pose. With a
+// coverage file set, it is saved every few seconds and only the tiles around the vehicle are kept in memory.
+// The areas are counted with the cells of the strips, so they are updated in constant time per pose.
+// The sections are switched ahead of time: the edges are predicted along the current path (speed and yaw
+// rate) by the latency of the implement to switch on/off, and the coverage and the field boundary are
+// checked there. The strips are only added once the implement has really switched
 class SectionControl : public BlockBase {
     Q_OBJECT
 
   public:
     explicit SectionControl( const QString& uniqueName,
                              MyMainWindow* mainWindow,
-                             Qt3DCore::QEntity* rootEntity,
-                             Qt3DRender::QFrameGraphNode* frameGraphParent );
+                             GeographicConvertionWrapper* tmw );
     ~SectionControl();
 
   public slots:
-    void setPose( const Point_3, const QQuaternion, const PoseOption::Options );
+    void setPose( const Pose& );
     void setImplement( const QPointer<Implement>& );
     void setSections();
-    void setLayer( Qt3DRender::QLayer* );
-    void onImageRendered();
+    void setCoverageFile( const QString& fileName );
+    void setSectionOfArea( double number );
+    void setField( std::shared_ptr<Polygon_with_holes_2> field );
 
-  private:
-    void requestRenderCapture();
+    // in s
+    void setSwitchOnLatency( double latency );
+    void setSwitchOffLatency( double latency );
 
   signals:
+    // in ha
+    void workedAreaChanged( double );
+    void overlapAreaChanged( double );
+    void areaOfSectionChanged( double );
+
+    // in % of the area of the sections
+    void overlapChanged( double );
 
   public:
-    KDDockWidgets::DockWidget* dock = nullptr;
-    QLabel* label = nullptr;
+    virtual void emitConfigSignals() override;
 
   private:
-    Qt3DRender::QFrameGraphNode* frameGraphParent = nullptr;
-    Qt3DRender::QFrameGraphNode* frameGraph = nullptr;
-    Qt3DRender::QLayerFilter* layerFilter = nullptr;
+    // the same rule as in CultivatedAreaModel::setSections()
+    bool isSectionOn( std::size_t sectionIndex );
 
-    Qt3DRender::QCamera* cameraEntity = nullptr;
-    QVector3D cameraOffset = QVector3D( 0, 0, 50 );
+    void updateAutomaticStates();
+    void updateSwitchTimes( qint64 timestamp );
+    bool isSectionWorking( std::size_t sectionIndex, qint64 timestamp );
 
-    TextureRenderTarget* textureTarget = nullptr;
-    Qt3DRender::QRenderCapture* renderCapture = nullptr;
-    Qt3DRender::QRenderCaptureReply* reply = nullptr;
+    // the edges after latency seconds along the current path, plus lookAheadDistance
+    void predictEdges( double latency, std::vector<Point_2>& edges );
+
+    // the part of the segment, which shouldn't get worked (over worked ground or outside of the field)
+    double coverageOfSegment( const Point_2& from, const Point_2& to );
+    bool isInField( const Point_2& point );
+    void updateImage();
+    void emitAreas();
+
+  public:
+    KDDockWidgets::DockWidget* dock = nullptr;
+    QLabel* label = nullptr;
+
+  private:
+    GeographicConvertionWrapper* tmw = nullptr;
 
     QPointer<Implement> implement;
 
     std::vector<double> sectionOffsets;
+
+    CoverageMap coverageMap;
+    QElapsedTimer timeSinceFlush;
+
+    static constexpr qint64 flushInterval = 5000;
+    static constexpr double distanceOfTilesInMemory = 250;
+
+    // the cells worked over again and the cells worked by every section, since the start
+    std::size_t overlapCells = 0;
+    std::vector<std::size_t> cellsOfSections;
+    std::size_t sectionOfArea = 1;
+
+    // the edges of the sections (left, right) at the last pose; the strips are added from there
+    std::vector<Point_2> lastEdges;
+    Point_2 lastPosition = Point_2( 0, 0 );
+    Vector_2 lastHeading = Vector_2( 1, 0 );
+    qint64 lastTimestamp = 0;
+    bool lastEdgesValid = false;
+
+    // in m/s and rad/s, filtered over the last poses
+    double velocity = 0;
+    double yawRate = 0;
+    static constexpr double filterFactor = 0.5;
+
+    // in s; the time from the command to the implement working/stopping
+    double switchOnLatency = 0;
+    double switchOffLatency = 0;
+
+    // the last commanded state of the sections and the time it was set, to know when the implement really works
+    std::vector<bool> sectionsCommandedOn;
+    std::vector<qint64> timesOfSwitch;
+
+    std::shared_ptr<Polygon_with_holes_2> field;
+    Bbox_2 bboxOfField;
+
+    // the points of the segment of a section checked against the boundary
+    static constexpr int pointsInFieldToCheck = 5;
+
+    // a jump of the position doesn't get worked
+    static constexpr double maxDistanceBetweenPoses = 5;
+
+    // the coverage is checked ahead of the edges, as the last strip ends at them
+    static constexpr double lookAheadDistance = 2 * CoverageMap::cellSize;
+
+    // a section is switched off, if more of it is over worked ground
+    static constexpr double maxCoverage = 0.5;
+
+    QImage image;
 };
 
 class SectionControlFactory : public BlockFactory {
@@ -88,14 +156,12 @@ class SectionControlFactory : public BlockFactory {
     SectionControlFactory( MyMainWindow* mainWindow,
                            KDDockWidgets::Location location,
                            QMenu* menu,
-                           Qt3DCore::QEntity* rootEntity,
-                           Qt3DRender::QFrameGraphNode* frameGraphParent )
+                           GeographicConvertionWrapper* tmw )
       : BlockFactory(),
         mainWindow( mainWindow ),
         location( location ),
         menu( menu ),
-        rootEntity( rootEntity ),
-        frameGraphParent( frameGraphParent ) {}
+        tmw( tmw ) {}
 
     QString getNameOfFactory() override {
       return QStringLiteral( "Section Control" );
@@ -108,8 +174,7 @@ class SectionControlFactory : public BlockFactory {
 
       auto* object = new SectionControl( getNameOfFactory() + QString::number( id ),
                                          mainWindow,
-                                         rootEntity,
-                                         frameGraphParent );
+                                         tmw );
       auto* b = createBaseBlock( scene, object, id );
 
       object->dock->setTitle( getNameOfFactory() );
@@ -119,10 +184,19 @@ class SectionControlFactory : public BlockFactory {
 
       mainWindow->addDockWidget( object->dock, location );
 
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
       b->addInputPort( QStringLiteral( "Implement Data" ), QLatin1String( SLOT( setImplement( const QPointer<Implement> ) ) ) );
       b->addInputPort( QStringLiteral( "Section Control Data" ), QLatin1String( SLOT( setSections() ) ) );
-      b->addInputPort( QStringLiteral( "Cultivated Area" ), QLatin1String( SLOT( setLayer( Qt3DRender::QLayer* ) ) ) );
+      b->addInputPort( QStringLiteral( "Coverage File" ), QLatin1String( SLOT( setCoverageFile( const QString& ) ) ) );
+      b->addInputPort( QStringLiteral( "Section # for Area" ), QLatin1String( SLOT( setSectionOfArea( double ) ) ) );
+      b->addInputPort( QStringLiteral( "Field" ), QLatin1String( SLOT( setField( std::shared_ptr<Polygon_with_holes_2> ) ) ) );
+      b->addInputPort( QStringLiteral( "Switch On Latency" ), QLatin1String( SLOT( setSwitchOnLatency( double ) ) ) );
+      b->addInputPort( QStringLiteral( "Switch Off Latency" ), QLatin1String( SLOT( setSwitchOffLatency( double ) ) ) );
+
+      b->addOutputPort( QStringLiteral( "Worked Area" ), QLatin1String( SIGNAL( workedAreaChanged( double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Overlap Area" ), QLatin1String( SIGNAL( overlapAreaChanged( double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Overlap %" ), QLatin1String( SIGNAL( overlapChanged( double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Area of Section" ), QLatin1String( SIGNAL( areaOfSectionChanged( double ) ) ) );
 
       return b;
     }
@@ -131,6 +205,5 @@ class SectionControlFactory : public BlockFactory {
     MyMainWindow* mainWindow = nullptr;
     KDDockWidgets::Location location;
     QMenu* menu = nullptr;
-    Qt3DCore::QEntity* rootEntity = nullptr;
-    Qt3DRender::QFrameGraphNode* frameGraphParent = nullptr;
+    GeographicConvertionWrapper* tmw = nullptr;
 };
@@ -29,7 +29,7 @@
 #include "qneport.h"
 
 #include "../kinematic/cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 #include "../kinematic/PathPrimitive.h"
 
 #include <QVector>
@@ -56,19 +56,19 @@ class StanleyGuidance : public BlockBase {
       this->steeringAngle = steeringAngle;
     }
 
-    void setPoseFrontWheels( const Point_3 position, QQuaternion orientation, PoseOption::Options options ) {
-      if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
-        this->positionFrontWheels = position;
+    void setPoseFrontWheels( const Pose& pose ) {
+      if( !pose.options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
+        this->positionFrontWheels = pose.position;
         this->orientation1AgoFrontWheels = this->orientationFrontWheels;
-        this->orientationFrontWheels = orientation;
+        this->orientationFrontWheels = pose.orientation;
       }
     }
 
-    void setPoseRearWheels( const Point_3 position, QQuaternion orientation, PoseOption::Options options ) {
-      if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
-        this->positionRearWheels = position;
+    void setPoseRearWheels( const Pose& pose ) {
+      if( !pose.options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
+        this->positionRearWheels = pose.position;
         this->orientation1AgoRearWheels = this->orientationRearWheels;
-        this->orientationRearWheels = orientation;
+        this->orientationRearWheels = pose.orientation;
       }
     }
 
@@ -221,8 +221,8 @@ class StanleyGuidanceFactory : public BlockFactory {
       auto* obj = new StanleyGuidance();
       auto* b = createBaseBlock( scene, obj, id );
 
-      b->addInputPort( QStringLiteral( "Pose Front Wheels" ), QLatin1String( SLOT( setPoseFrontWheels( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
-      b->addInputPort( QStringLiteral( "Pose Rear Wheels" ), QLatin1String( SLOT( setPoseRearWheels( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose Front Wheels" ), QLatin1String( SLOT( setPoseFrontWheels( const Pose& ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose Rear Wheels" ), QLatin1String( SLOT( setPoseRearWheels( const Pose& ) ) ) );
       b->addInputPort( QStringLiteral( "Steering Angle" ), QLatin1String( SLOT( setSteeringAngle( double ) ) ) );
 
       b->addInputPort( QStringLiteral( "Velocity" ), QLatin1String( SLOT( setVelocity( double ) ) ) );
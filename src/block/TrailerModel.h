@@ -33,7 +33,7 @@
 
 #include "../kinematic/cgalKernel.h"
 
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 
 class TrailerModel : public BlockBase {
     Q_OBJECT
@@ -43,9 +43,9 @@ class TrailerModel : public BlockBase {
     ~TrailerModel();
 
   public slots:
-    void setPoseHookPoint( const Point_3, const QQuaternion, const PoseOption::Options );
-    void setPoseTowPoint( const Point_3, const QQuaternion, const PoseOption::Options );
-    void setPosePivotPoint( const Point_3, const QQuaternion, const PoseOption::Options );
+    void setPoseHookPoint( const Pose& );
+    void setPoseTowPoint( const Pose& );
+    void setPosePivotPoint( const Pose& );
 
     void setOffsetHookPointPosition( QVector3D position );
     void setTrackwidth( double trackwidth );
@@ -107,9 +107,9 @@ class TrailerModelFactory : public BlockFactory {
 
       b->addInputPort( QStringLiteral( "Track Width" ), QLatin1String( SLOT( setTrackwidth( double ) ) ) );
       b->addInputPort( QStringLiteral( "Offset Hook Point" ), QLatin1String( SLOT( setOffsetHookPointPosition( QVector3D ) ) ) );
-      b->addInputPort( QStringLiteral( "Pose Hook Point" ), QLatin1String( SLOT( setPoseHookPoint( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
-      b->addInputPort( QStringLiteral( "Pose Pivot Point" ), QLatin1String( SLOT( setPosePivotPoint( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
-      b->addInputPort( QStringLiteral( "Pose Tow Point" ), QLatin1String( SLOT( setPoseTowPoint( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose Hook Point" ), QLatin1String( SLOT( setPoseHookPoint( const Pose& ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose Pivot Point" ), QLatin1String( SLOT( setPosePivotPoint( const Pose& ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose Tow Point" ), QLatin1String( SLOT( setPoseTowPoint( const Pose& ) ) ) );
 
       b->setBrush( modelColor );
 
@@ -26,6 +26,7 @@
 #include "moc_FieldManager.cpp"
 #include "moc_FileStream.cpp"
 #include "moc_FpsMeasurement.cpp"
+#include "moc_FrameTiming.cpp"
 #include "moc_GlobalPlanner.cpp"
 #include "moc_GridModel.cpp"
 #include "moc_PathPlannerModel.cpp"
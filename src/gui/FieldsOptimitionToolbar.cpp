@@ -29,17 +29,22 @@ FieldsOptimitionToolbar::FieldsOptimitionToolbar( QWidget* parent ) :
   emit recalculateFieldSettingsChanged( AlphaType( ui->cbAlphaShape->currentIndex() ),
                                         ui->dsbAlpha->value(),
                                         ui->dsbMaxDeviation->value(),
-                                        ui->cbConnectEndToStart->isChecked() ? ui->dsbDistanceConnectingPoints->value() : 0 );
+                                        ui->cbConnectEndToStart->isChecked() ? ui->dsbDistanceConnectingPoints->value() : 0,
+                                        ui->cbThinPoints->isChecked() ? ui->dsbMinDistanceBetweenPoints->value() : 0 );
 }
 
 FieldsOptimitionToolbar::~FieldsOptimitionToolbar() {
   delete ui;
 }
 
-void FieldsOptimitionToolbar::setAlpha( double optimalAlpha, double solidAlpha ) {
+void FieldsOptimitionToolbar::setAlpha( double optimalAlpha, double solidAlpha, bool estimated ) {
   this->optimalAlpha = optimalAlpha;
   this->solidAlpha = solidAlpha;
 
+  // big fields are calculated in tiles, their alpha is estimated from a thinned out copy of the points
+  ui->dsbAlpha->setPrefix( estimated ? QStringLiteral( "~" ) : QString() );
+  ui->dsbAlpha->setToolTip( estimated ? QStringLiteral( "Estimated from a thinned out copy of the points" ) : QString() );
+
   if( ui->cbAlphaShape->currentText() == QLatin1String( "Optimal" ) ) {
     ui->dsbAlpha->setValue( optimalAlpha );
   }
@@ -49,11 +54,16 @@ void FieldsOptimitionToolbar::setAlpha( double optimalAlpha, double solidAlpha )
   }
 }
 
+void FieldsOptimitionToolbar::setProgress( int percent ) {
+  ui->pbProgress->setValue( percent );
+}
+
 void FieldsOptimitionToolbar::on_pbRecalculate_clicked() {
   emit recalculateFieldSettingsChanged( AlphaType( ui->cbAlphaShape->currentIndex() ),
                                         ui->dsbAlpha->value(),
                                         ui->dsbMaxDeviation->value(),
-                                        ui->cbConnectEndToStart->isChecked() ? ui->dsbDistanceConnectingPoints->value() : 0 );
+                                        ui->cbConnectEndToStart->isChecked() ? ui->dsbDistanceConnectingPoints->value() : 0,
+                                        ui->cbThinPoints->isChecked() ? ui->dsbMinDistanceBetweenPoints->value() : 0 );
   emit recalculateField();
 }
 
@@ -71,7 +81,8 @@ void FieldsOptimitionToolbar::on_cbAlphaShape_currentTextChanged( const QString&
   emit recalculateFieldSettingsChanged( AlphaType( ui->cbAlphaShape->currentIndex() ),
                                         ui->dsbAlpha->value(),
                                         ui->dsbMaxDeviation->value(),
-                                        ui->cbConnectEndToStart->isChecked() ? ui->dsbDistanceConnectingPoints->value() : 0 );
+                                        ui->cbConnectEndToStart->isChecked() ? ui->dsbDistanceConnectingPoints->value() : 0,
+                                        ui->cbThinPoints->isChecked() ? ui->dsbMinDistanceBetweenPoints->value() : 0 );
 }
 
 void FieldsOptimitionToolbar::on_cbConnectEndToStart_stateChanged( int ) {
@@ -79,26 +90,46 @@ void FieldsOptimitionToolbar::on_cbConnectEndToStart_stateChanged( int ) {
   emit recalculateFieldSettingsChanged( AlphaType( ui->cbAlphaShape->currentIndex() ),
                                         ui->dsbAlpha->value(),
                                         ui->dsbMaxDeviation->value(),
-                                        ui->cbConnectEndToStart->isChecked() ? ui->dsbDistanceConnectingPoints->value() : 0 );
+                                        ui->cbConnectEndToStart->isChecked() ? ui->dsbDistanceConnectingPoints->value() : 0,
+                                        ui->cbThinPoints->isChecked() ? ui->dsbMinDistanceBetweenPoints->value() : 0 );
 }
 
 void FieldsOptimitionToolbar::on_dsbDistanceConnectingPoints_valueChanged( double ) {
   emit recalculateFieldSettingsChanged( AlphaType( ui->cbAlphaShape->currentIndex() ),
                                         ui->dsbAlpha->value(),
                                         ui->dsbMaxDeviation->value(),
-                                        ui->cbConnectEndToStart->isChecked() ? ui->dsbDistanceConnectingPoints->value() : 0 );
+                                        ui->cbConnectEndToStart->isChecked() ? ui->dsbDistanceConnectingPoints->value() : 0,
+                                        ui->cbThinPoints->isChecked() ? ui->dsbMinDistanceBetweenPoints->value() : 0 );
 }
 
 void FieldsOptimitionToolbar::on_dsbAlpha_valueChanged( double ) {
   emit recalculateFieldSettingsChanged( AlphaType( ui->cbAlphaShape->currentIndex() ),
                                         ui->dsbAlpha->value(),
                                         ui->dsbMaxDeviation->value(),
-                                        ui->cbConnectEndToStart->isChecked() ? ui->dsbDistanceConnectingPoints->value() : 0 );
+                                        ui->cbConnectEndToStart->isChecked() ? ui->dsbDistanceConnectingPoints->value() : 0,
+                                        ui->cbThinPoints->isChecked() ? ui->dsbMinDistanceBetweenPoints->value() : 0 );
 }
 
 void FieldsOptimitionToolbar::on_dsbMaxDeviation_valueChanged( double ) {
   emit recalculateFieldSettingsChanged( AlphaType( ui->cbAlphaShape->currentIndex() ),
                                         ui->dsbAlpha->value(),
                                         ui->dsbMaxDeviation->value(),
-                                        ui->cbConnectEndToStart->isChecked() ? ui->dsbDistanceConnectingPoints->value() : 0 );
+                                        ui->cbConnectEndToStart->isChecked() ? ui->dsbDistanceConnectingPoints->value() : 0,
+                                        ui->cbThinPoints->isChecked() ? ui->dsbMinDistanceBetweenPoints->value() : 0 );
+}
+
+void FieldsOptimitionToolbar::on_cbThinPoints_stateChanged( int ) {
+  emit recalculateFieldSettingsChanged( AlphaType( ui->cbAlphaShape->currentIndex() ),
+                                        ui->dsbAlpha->value(),
+                                        ui->dsbMaxDeviation->value(),
+                                        ui->cbConnectEndToStart->isChecked() ? ui->dsbDistanceConnectingPoints->value() : 0,
+                                        ui->cbThinPoints->isChecked() ? ui->dsbMinDistanceBetweenPoints->value() : 0 );
+}
+
+void FieldsOptimitionToolbar::on_dsbMinDistanceBetweenPoints_valueChanged( double ) {
+  emit recalculateFieldSettingsChanged( AlphaType( ui->cbAlphaShape->currentIndex() ),
+                                        ui->dsbAlpha->value(),
+                                        ui->dsbMaxDeviation->value(),
+                                        ui->cbConnectEndToStart->isChecked() ? ui->dsbDistanceConnectingPoints->value() : 0,
+                                        ui->cbThinPoints->isChecked() ? ui->dsbMinDistanceBetweenPoints->value() : 0 );
 }
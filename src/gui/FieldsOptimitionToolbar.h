@@ -40,10 +40,12 @@ class FieldsOptimitionToolbar : public QGroupBox {
 
   signals:
     void recalculateField();
-    void recalculateFieldSettingsChanged( FieldsOptimitionToolbar::AlphaType alphaType, double customAlpha, double maxDeviation, double distanceBetweenConnectPoints );
+    void recalculateFieldSettingsChanged( FieldsOptimitionToolbar::AlphaType alphaType, double customAlpha, double maxDeviation, double distanceBetweenConnectPoints, double minDistanceBetweenPoints );
 
   public slots:
-    void setAlpha( double optimal, double solid );
+    // estimated: shown with a prefix on the alpha, see CgalWorker::estimateAlpha()
+    void setAlpha( double optimal, double solid, bool estimated );
+    void setProgress( int percent );
 
   private slots:
     void on_pbRecalculate_clicked();
@@ -58,6 +60,10 @@ class FieldsOptimitionToolbar : public QGroupBox {
 
     void on_dsbMaxDeviation_valueChanged( double arg1 );
 
+    void on_cbThinPoints_stateChanged( int );
+
+    void on_dsbMinDistanceBetweenPoints_valueChanged( double );
+
   private:
     Ui::FieldsOptimitionToolbar* ui = nullptr;
 
@@ -0,0 +1,134 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "HeadlessRunner.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QMenu>
+#include <QDebug>
+#include <QVector>
+
+#include <algorithm>
+#include <limits>
+
+#include <Qt3DCore/QEntity>
+
+#include "MyMainWindow.h"
+#include "SettingsDialog.h"
+
+#include "qneblock.h"
+#include "qneconnection.h"
+#include "qnegraph.h"
+
+#include "../block/FileStream.h"
+
+int HeadlessRunner::run( const QString& configFile, const QString& replayFile, bool benchmarkConnections ) {
+  // the main window is needed by the system blocks to attach their docks; it is never shown.
+  // The root entity is never added to an aspect engine, so nothing gets rendered
+  auto* mainWindow = new MyMainWindow( QStringLiteral( "QtOpenGuidanceHeadless" ), KDDockWidgets::MainWindowOption_None );
+  auto* rootEntity = new Qt3DCore::QEntity();
+  auto* menu = new QMenu( mainWindow );
+
+  auto* settingsDialog = new SettingsDialog( rootEntity, mainWindow, nullptr, menu, mainWindow );
+  settingsDialog->emitAllConfigSignals();
+
+  QElapsedTimer timer;
+  timer.start();
+
+  if( !settingsDialog->loadConfig( configFile ) ) {
+    return 1;
+  }
+
+  qInfo() << "Headless: loaded config" << configFile << "in" << timer.elapsed() << "ms";
+
+  QVector<FileStream*> fileStreams;
+
+  {
+    const auto& constRefOfList = settingsDialog->getSceneOfConfigGraphicsView()->items();
+
+    for( const auto& item : constRefOfList ) {
+      auto* block = qgraphicsitem_cast<QNEBlock*>( item );
+
+      if( block != nullptr ) {
+        auto* fileStream = qobject_cast<FileStream*>( block->object );
+
+        if( fileStream != nullptr ) {
+          if( !replayFile.isEmpty() ) {
+            fileStream->setFilename( replayFile );
+          }
+
+          fileStreams.push_back( fileStream );
+        }
+      }
+    }
+  }
+
+  auto replay = [&fileStreams]( qint64 & lines ) {
+    QElapsedTimer timer;
+    timer.start();
+
+    lines = 0;
+
+    for( const auto& fileStream : qAsConst( fileStreams ) ) {
+      lines += fileStream->replayAll();
+    }
+
+    // process the queued signals of the worker threads
+    QCoreApplication::processEvents();
+
+    return timer.nsecsElapsed();
+  };
+
+  auto nameOfMode = []( QNEConnection::Mode mode ) {
+    return mode == QNEConnection::Mode::Compiled ? "(compiled connections)" : "(signal connections)";
+  };
+
+  if( !benchmarkConnections ) {
+    qint64 lines = 0;
+    const qint64 elapsedNs = replay( lines );
+
+    qInfo() << "Headless: replayed" << lines << "lines in" << double( elapsedNs ) / 1e6 << "ms ->"
+            << ( elapsedNs > 0 ? double( lines ) / ( double( elapsedNs ) / 1e9 ) : 0. ) << "lines/s,"
+            << ( lines > 0 ? double( elapsedNs ) / double( lines ) / 1e3 : 0. ) << "us/line"
+            << nameOfMode( QNEConnection::mode );
+  } else {
+    auto* scene = settingsDialog->getSceneOfConfigGraphicsView();
+    qint64 lines = 0;
+    qint64 best[2] = { std::numeric_limits<qint64>::max(), std::numeric_limits<qint64>::max() };
+
+    // alternately, so the state the blocks build up over the runs affects both the same
+    for( int i = 0; i < 3; ++i ) {
+      for( const auto mode : { QNEConnection::Mode::Signal, QNEConnection::Mode::Compiled } ) {
+        QNEGraph::setMode( scene, mode );
+        auto& bestOfMode = best[mode == QNEConnection::Mode::Compiled ? 1 : 0];
+        bestOfMode = std::min( bestOfMode, replay( lines ) );
+      }
+    }
+
+    for( const auto mode : { QNEConnection::Mode::Signal, QNEConnection::Mode::Compiled } ) {
+      const qint64 elapsedNs = best[mode == QNEConnection::Mode::Compiled ? 1 : 0];
+      qInfo() << "Headless: replayed" << lines << "lines, best of 3:" << double( elapsedNs ) / 1e6 << "ms ->"
+              << ( lines > 0 ? double( elapsedNs ) / double( lines ) / 1e3 : 0. ) << "us/line" << nameOfMode( mode );
+    }
+
+    qInfo() << "Headless: the compiled connections save" << ( lines > 0 ? double( best[0] - best[1] ) / double( lines ) / 1e3 : 0. ) << "us/line";
+  }
+
+  return 0;
+}
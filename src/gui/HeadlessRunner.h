@@ -0,0 +1,34 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QString>
+
+// runs a saved config without the 3D view: all the blocks, which only render something or
+// show a dock, are skipped. The file streams are fed with the replay file as fast as possible
+// and the throughput is printed at the end.
+// With benchmarkConnections, the replay is run alternately with the connections in QNEConnection::Mode::Signal
+// and QNEConnection::Mode::Compiled, and the best time of each is printed: the difference is the cost of the
+// propagation through the signals of Qt.
+class HeadlessRunner {
+  public:
+    HeadlessRunner() {}
+
+    int run( const QString& configFile, const QString& replayFile, bool benchmarkConnections = false );
+};
@@ -21,6 +21,10 @@
 #include <QtWidgets>
 #include <QObject>
 #include <QSignalBlocker>
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <cmath>
 
 #include <QFileDialog>
 
@@ -34,6 +38,7 @@
 #include "qneblock.h"
 #include "qneconnection.h"
 #include "qneport.h"
+#include "qnegraph.h"
 #include "qnodeseditor.h"
 
 #include "SettingsDialog.h"
@@ -42,6 +47,7 @@
 #include "MyMainWindow.h"
 #include <Qt3DExtras/Qt3DWindow>
 #include <Qt3DExtras/QForwardRenderer>
+#include <Qt3DRender/QRenderSettings>
 
 #include "../block/VectorObject.h"
 #include "../block/NumberObject.h"
@@ -104,6 +110,27 @@
 #include <Qt3DExtras/QMetalRoughMaterial>
 #include <Qt3DExtras/QDiffuseSpecularMaterial>
 
+#include <QOpenGLContext>
+#include <QOffscreenSurface>
+
+// the procedural grid needs fwidth(), which OpenGL ES 2 only has with GL_OES_standard_derivatives
+static bool supportsProceduralGrid( const QSurfaceFormat& format ) {
+  if( format.renderableType() != QSurfaceFormat::OpenGLES || format.majorVersion() >= 3 ) {
+    return true;
+  }
+
+  // the window has no context yet, so ask a temporary one with the same format
+  QOffscreenSurface surface;
+  surface.setFormat( format );
+  surface.create();
+
+  QOpenGLContext context;
+  context.setFormat( format );
+
+  return context.create() && context.makeCurrent( &surface ) &&
+         context.hasExtension( QByteArrayLiteral( "GL_OES_standard_derivatives" ) );
+}
+
 SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity, MyMainWindow* mainWindow, Qt3DExtras::Qt3DWindow* qt3dWindow, QMenu* guidanceToolbarMenu, QWidget* parent ) :
   QDialog( parent ),
   mainWindow( mainWindow ),
@@ -142,6 +169,7 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity, MyMainWindow* mai
       ui->dsbGridSize->setValue( settings.value( QStringLiteral( "Grid/Size" ), 10 ).toDouble() );
       ui->dsbGridCameraThreshold->setValue( settings.value( QStringLiteral( "Grid/CameraThreshold" ), 75 ).toDouble() );
       ui->dsbGridCameraThresholdCoarse->setValue( settings.value( QStringLiteral( "Grid/CameraThresholdCoarse" ), 250 ).toDouble() );
+      ui->cbGridProcedural->setChecked( settings.value( QStringLiteral( "Grid/Procedural" ), false ).toBool() );
       gridColor = settings.value( QStringLiteral( "Grid/Color" ), QColor( 0x6b, 0x96, 0xa8 ) ).value<QColor>();
       gridColorCoarse = settings.value( QStringLiteral( "Grid/ColorCoarse" ), QColor( 0xa2, 0xe3, 0xff ) ).value<QColor>();
     }
@@ -172,6 +200,12 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity, MyMainWindow* mai
 
       ui->dsbGamma->setValue( gamma );
       ui->cbShowDebugOverlay->setChecked( showDebugOverlay );
+
+      ui->cbRenderOnDemand->setChecked( settings.value( QStringLiteral( "Qt3D/RenderOnDemand" ), true ).toBool() );
+      ui->sbMaxFrameRate->setValue( settings.value( QStringLiteral( "Qt3D/MaxFrameRate" ), 30 ).toInt() );
+
+      // the window isn't shown yet, so the limit of the frame rate can still be set
+      setRenderPolicy();
     }
 
     blockSettingsSaving = false;
@@ -179,10 +213,20 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity, MyMainWindow* mai
 
   bool usePBR = true;
 
-  if( qt3dWindow->format().majorVersion() <= 2 || ui->rbMaterialPhong->isChecked() ) {
+  if( qt3dWindow == nullptr || qt3dWindow->format().majorVersion() <= 2 || ui->rbMaterialPhong->isChecked() ) {
     usePBR = false;
   }
 
+  // instancing needs OpenGL 3 or OpenGL ES 3
+  const bool instancedMarkers = qt3dWindow != nullptr && qt3dWindow->format().majorVersion() >= 3;
+
+  if( qt3dWindow != nullptr && !supportsProceduralGrid( qt3dWindow->format() ) ) {
+    QSignalBlocker blocker( ui->cbGridProcedural );
+    ui->cbGridProcedural->setChecked( false );
+    ui->cbGridProcedural->setEnabled( false );
+    ui->cbGridProcedural->setToolTip( tr( "Needs OpenGL ES 3 or GL_OES_standard_derivatives" ) );
+  }
+
   ui->gvNodeEditor->setDragMode( QGraphicsView::RubberBandDrag );
 
   auto* scene = new QGraphicsScene();
@@ -287,6 +331,35 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity, MyMainWindow* mai
     auto saveFieldAction = newOpenSaveToolbar->saveMenu->addAction( QStringLiteral( "Save Field" ) );
     QObject::connect( saveFieldAction, &QAction::triggered, fieldManagerObject, &FieldManager::saveField );
 
+    // the library of saved fields; the directory and the automatic selection are kept in the settings
+    {
+      QSettings settings( QStandardPaths::writableLocation( QStandardPaths::AppDataLocation ) + "/config.ini",
+                          QSettings::IniFormat );
+
+      auto openFieldLibraryAction = newOpenSaveToolbar->openMenu->addAction( QStringLiteral( "Open Field Library" ) );
+      QObject::connect( openFieldLibraryAction, &QAction::triggered, fieldManagerObject, &FieldManager::openFieldLibrary );
+
+      auto selectFieldFromLibraryAction = newOpenSaveToolbar->openMenu->addAction( QStringLiteral( "Select Field from Library by Position" ) );
+      selectFieldFromLibraryAction->setCheckable( true );
+      selectFieldFromLibraryAction->setChecked( settings.value( QStringLiteral( "FieldLibrary/SelectByPosition" ), false ).toBool() );
+      QObject::connect( selectFieldFromLibraryAction, &QAction::toggled, fieldManagerObject, &FieldManager::setSelectFieldFromLibrary );
+      QObject::connect( selectFieldFromLibraryAction, &QAction::toggled, this, []( bool checked ) {
+        QSettings settings( QStandardPaths::writableLocation( QStandardPaths::AppDataLocation ) + "/config.ini",
+                            QSettings::IniFormat );
+        settings.setValue( QStringLiteral( "FieldLibrary/SelectByPosition" ), checked );
+        settings.sync();
+      } );
+      fieldManagerObject->setSelectFieldFromLibrary( selectFieldFromLibraryAction->isChecked() );
+
+      fieldManagerObject->setFieldLibraryDirectory( settings.value( QStringLiteral( "FieldLibrary/Directory" ) ).toString() );
+      QObject::connect( fieldManagerObject, &FieldManager::fieldLibraryDirectoryChanged, this, []( const QString & directory ) {
+        QSettings settings( QStandardPaths::writableLocation( QStandardPaths::AppDataLocation ) + "/config.ini",
+                            QSettings::IniFormat );
+        settings.setValue( QStringLiteral( "FieldLibrary/Directory" ), directory );
+        settings.sync();
+      } );
+    }
+
     fieldManager = fieldManagerObject;
   }
 
@@ -298,7 +371,8 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity, MyMainWindow* mai
       KDDockWidgets::Location_OnRight,
       guidanceToolbarMenu,
       geographicConvertionWrapperGuidance,
-      rootEntity );
+      rootEntity,
+      instancedMarkers );
   auto* globalPlannerBlock = globalPlannerFactory->createBlock( ui->gvNodeEditor->scene() );
 
   {
@@ -323,11 +397,11 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity, MyMainWindow* mai
       guidanceToolbarMenu );
   stanleyGuidanceFactory = new StanleyGuidanceFactory();
   xteGuidanceFactory = new XteGuidanceFactory();
+
   sectionControlFactory = new SectionControlFactory( mainWindow,
       KDDockWidgets::Location_OnBottom,
       guidanceToolbarMenu,
-      rootEntity,
-      static_cast<Qt3DRender::QFrameGraphNode*>( qt3dWindow->activeFrameGraph()->children().front() ) );
+      geographicConvertionWrapperGuidance );
 
   pathPlannerModelFactory = new PathPlannerModelFactory( rootEntity );
 
@@ -365,15 +439,27 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity, MyMainWindow* mai
   valueTransmissionStateFactory = new ValueTransmissionStateFactory();
   valueTransmissionBase64DataFactory = new ValueTransmissionBase64DataFactory();
 
+  // the blocks, which only render something, are left out in the headless mode. They are skipped
+  // when a config is loaded, as there is no factory for them in the combobox
+  const bool withWindow = qt3dWindow != nullptr;
+
   vectorFactory->addToCombobox( ui->cbNodeType );
   numberFactory->addToCombobox( ui->cbNodeType );
   stringFactory->addToCombobox( ui->cbNodeType );
   fixedKinematicFactory->addToCombobox( ui->cbNodeType );
-  tractorModelFactory->addToCombobox( ui->cbNodeType );
+
+  if( withWindow ) {
+    tractorModelFactory->addToCombobox( ui->cbNodeType );
+  }
+
   trailerKinematicFactory->addToCombobox( ui->cbNodeType );
-  trailerModelFactory->addToCombobox( ui->cbNodeType );
-  sprayerModelFactory->addToCombobox( ui->cbNodeType );
-  cultivatedAreaModelFactory->addToCombobox( ui->cbNodeType );
+
+  if( withWindow ) {
+    trailerModelFactory->addToCombobox( ui->cbNodeType );
+    sprayerModelFactory->addToCombobox( ui->cbNodeType );
+    cultivatedAreaModelFactory->addToCombobox( ui->cbNodeType );
+  }
+
   ackermannSteeringFactory->addToCombobox( ui->cbNodeType );
   angularVelocityLimiterFactory->addToCombobox( ui->cbNodeType );
   poseSynchroniserFactory->addToCombobox( ui->cbNodeType );
@@ -382,7 +468,11 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity, MyMainWindow* mai
   stanleyGuidanceFactory->addToCombobox( ui->cbNodeType );
   localPlannerFactory->addToCombobox( ui->cbNodeType );
   sectionControlFactory->addToCombobox( ui->cbNodeType );
-  pathPlannerModelFactory->addToCombobox( ui->cbNodeType );
+
+  if( withWindow ) {
+    pathPlannerModelFactory->addToCombobox( ui->cbNodeType );
+  }
+
   ubxParserFactory->addToCombobox( ui->cbNodeType );
   nmeaParserGGAFactory->addToCombobox( ui->cbNodeType );
   nmeaParserHDTFactory->addToCombobox( ui->cbNodeType );
@@ -416,7 +506,7 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity, MyMainWindow* mai
   this->on_pbComPortRefresh_clicked();
 
   // draw an axis-cross: X-red, Y-green, Z-blue
-  if( true ) {
+  if( qt3dWindow != nullptr ) {
     constexpr float metalness = 0.1f;
     constexpr float roughness = 0.5f;
 
@@ -717,19 +807,7 @@ void SettingsDialog::saveConfigToFile( QFile& file ) {
 }
 
 QNEBlock* SettingsDialog::getBlockWithId( int id ) {
-  const auto& constRefOfList = ui->gvNodeEditor->scene()->items();
-
-  for( const auto& item : constRefOfList ) {
-    auto* block = qgraphicsitem_cast<QNEBlock*>( item );
-
-    if( block != nullptr ) {
-      if( block->id == id ) {
-        return block;
-      }
-    }
-  }
-
-  return nullptr;
+  return QNEBlock::getBlockWithId( ui->gvNodeEditor->scene(), id );
 }
 
 QNEBlock* SettingsDialog::getBlockWithName( const QString& name ) {
@@ -814,18 +892,58 @@ void SettingsDialog::on_pbLoad_clicked() {
   fileDialog->open();
 }
 
+bool SettingsDialog::loadConfig( const QString& fileName ) {
+  QFile loadFile( fileName );
+
+  if( !loadFile.open( QIODevice::ReadOnly ) ) {
+    qWarning() << "Couldn't open config file" << fileName;
+    return false;
+  }
+
+  loadConfigFromFile( loadFile );
+  return true;
+}
+
 void SettingsDialog::loadConfigFromFile( QFile& file ) {
   QByteArray saveData = file.readAll();
 
   QJsonDocument loadDoc( QJsonDocument::fromJson( saveData ) );
   QJsonObject json = loadDoc.object();
 
-  // as the new object get new id, here is a QMap to hold the conversions
+  auto* scene = ui->gvNodeEditor->scene();
+
+  // suspend the propagation while loading: no repaints of the view, no updates of the index of the scene
+  // and the blocked signals of the blocks. The config signals are emitted once for every block at the end
+  ui->gvNodeEditor->setUpdatesEnabled( false );
+  const auto itemIndexMethod = scene->itemIndexMethod();
+  scene->setItemIndexMethod( QGraphicsScene::NoIndex );
+
+  // as the new object get new id, here is a QHash to hold the conversions
   // first int: id in file, second int: id in the graphicsview
-  QMap<int, int> idMap;
+  QHash<int, int> idMap;
+
+  // the blocks touched by this config, in the order of the file
+  QVector<QNEBlock*> loadedBlocks;
+  QVector<QNEBlock*> createdBlocks;
+
+  // the system blocks are found by their name; index them once instead of searching the scene for every block
+  QHash<QString, QNEBlock*> systemBlocks;
+  {
+    const auto& constRefOfList = scene->items();
+
+    for( const auto& item : constRefOfList ) {
+      auto* block = qgraphicsitem_cast<QNEBlock*>( item );
+
+      if( block != nullptr && block->systemBlock ) {
+        systemBlocks.insert( block->getName(), block );
+      }
+    }
+  }
 
   if( json.contains( QStringLiteral( "blocks" ) ) && json[QStringLiteral( "blocks" )].isArray() ) {
     QJsonArray blocksArray = json[QStringLiteral( "blocks" )].toArray();
+    loadedBlocks.reserve( blocksArray.size() );
+    createdBlocks.reserve( blocksArray.size() );
 
     for( const auto& blockIndex : qAsConst( blocksArray ) ) {
       QJsonObject blockObject = blockIndex.toObject();
@@ -836,12 +954,13 @@ void SettingsDialog::loadConfigFromFile( QFile& file ) {
 
         // system id -> don't create new blocks
         if( id < int( QNEBlock::IdRange::UserIdStart ) ) {
-          QNEBlock* block = getBlockWithName( blockObject[QStringLiteral( "type" )].toString() );
+          QNEBlock* block = systemBlocks.value( blockObject[QStringLiteral( "type" )].toString(), nullptr );
 
           if( block != nullptr ) {
             idMap.insert( id, block->id );
             block->setX( blockObject[QStringLiteral( "positionX" )].toDouble( 0 ) );
             block->setY( blockObject[QStringLiteral( "positionY" )].toDouble( 0 ) );
+            loadedBlocks.push_back( block );
           }
 
           // id is not a system-id -> create new blocks
@@ -850,7 +969,9 @@ void SettingsDialog::loadConfigFromFile( QFile& file ) {
           auto* factory = qobject_cast<BlockFactory*>( qvariant_cast<QObject*>( ui->cbNodeType->itemData( index ) ) );
 
           if( factory != nullptr ) {
-            QNEBlock* block = factory->createBlock( ui->gvNodeEditor->scene(), id );
+            QNEBlock* block = factory->createBlock( scene, id );
+            block->object->blockSignals( true );
+            createdBlocks.push_back( block );
 
             idMap.insert( id, block->id );
 
@@ -859,13 +980,13 @@ void SettingsDialog::loadConfigFromFile( QFile& file ) {
             block->setName( blockObject[QStringLiteral( "name" )].toString( factory->getNameOfFactory() ) );
             block->fromJSON( blockObject );
             block->setSelected( true );
+            loadedBlocks.push_back( block );
           }
         }
       }
     }
   }
 
-
   if( json.contains( QStringLiteral( "connections" ) ) && json[QStringLiteral( "connections" )].isArray() ) {
     QJsonArray connectionsArray = json[QStringLiteral( "connections" )].toArray();
 
@@ -877,8 +998,8 @@ void SettingsDialog::loadConfigFromFile( QFile& file ) {
           !connectionsObject[QStringLiteral( "portFrom" )].isUndefined() &&
           !connectionsObject[QStringLiteral( "portTo" )].isUndefined() ) {
 
-        int idFrom = idMap[connectionsObject[QStringLiteral( "idFrom" )].toInt()];
-        int idTo = idMap[connectionsObject[QStringLiteral( "idTo" )].toInt()];
+        int idFrom = idMap.value( connectionsObject[QStringLiteral( "idFrom" )].toInt(), 0 );
+        int idTo = idMap.value( connectionsObject[QStringLiteral( "idTo" )].toInt(), 0 );
 
         if( idFrom != 0 && idTo != 0 ) {
           QNEBlock* blockFrom = getBlockWithId( idFrom );
@@ -896,7 +1017,7 @@ void SettingsDialog::loadConfigFromFile( QFile& file ) {
               conn->setPort1( portFrom );
 
               if( conn->setPort2( portTo ) ) {
-                blockFrom->scene()->addItem( conn );
+                scene->addItem( conn );
                 conn->updatePosFromPorts();
                 conn->updatePath();
                 conn->setSelected( true );
@@ -910,14 +1031,33 @@ void SettingsDialog::loadConfigFromFile( QFile& file ) {
     }
   }
 
-  // as new values for the blocks are added above, emit all signals now, when the connections are made
-  const auto& constRefOfList = ui->gvNodeEditor->scene()->items();
+  // resume the propagation
+  for( const auto& block : qAsConst( createdBlocks ) ) {
+    block->object->blockSignals( false );
+  }
 
-  for( const auto& item : constRefOfList ) {
-    auto* block = qgraphicsitem_cast<QNEBlock*>( item );
+  scene->setItemIndexMethod( itemIndexMethod );
+  ui->gvNodeEditor->setUpdatesEnabled( true );
 
-    if( block != nullptr ) {
-      block->emitConfigSignals();
+  QNEGraph::compile( scene );
+
+  // as new values for the blocks are added above, emit all signals now, when the connections are made.
+  // Only the blocks of the loaded config and the system blocks are affected, the rest of the graph already
+  // has its values. The blocks are ordered topologically, so the blocks upstream have emitted their values before
+  {
+    QSet<const QNEBlock*> blocksToEmit;
+    blocksToEmit.reserve( loadedBlocks.size() );
+
+    for( const auto& block : qAsConst( loadedBlocks ) ) {
+      blocksToEmit.insert( block );
+    }
+
+    const auto order = QNEGraph::topologicalOrder( scene );
+
+    for( const auto& block : order ) {
+      if( block->systemBlock || blocksToEmit.contains( block ) ) {
+        block->emitConfigSignals();
+      }
     }
   }
 
@@ -1030,6 +1170,7 @@ void SettingsDialog::saveGridValuesInSettings() {
     settings.setValue( QStringLiteral( "Grid/Size" ), ui->dsbGridSize->value() );
     settings.setValue( QStringLiteral( "Grid/CameraThreshold" ), ui->dsbGridCameraThreshold->value() );
     settings.setValue( QStringLiteral( "Grid/CameraThresholdCoarse" ), ui->dsbGridCameraThresholdCoarse->value() );
+    settings.setValue( QStringLiteral( "Grid/Procedural" ), ui->cbGridProcedural->isChecked() );
     settings.setValue( QStringLiteral( "Grid/Color" ), gridColor );
     settings.sync();
   }
@@ -1069,6 +1210,7 @@ void SettingsDialog::setPathPlannerSettings() {
 
 void SettingsDialog::emitAllConfigSignals() {
   emit setGrid( ui->gbGrid->isChecked() );
+  emit setGridProcedural( ui->cbGridProcedural->isChecked() );
   emitGridSettings();
 
   emit plannerSettingsChanged( ui->sbPathsInReserve->value(), ui->sbGlobalPlannerMaxDeviation->value() );
@@ -1346,6 +1488,11 @@ void SettingsDialog::on_dsbGridCameraThresholdCoarse_valueChanged( double ) {
   emitGridSettings();
 }
 
+void SettingsDialog::on_cbGridProcedural_toggled( bool checked ) {
+  saveGridValuesInSettings();
+  emit setGridProcedural( checked );
+}
+
 void SettingsDialog::emitGridSettings() {
   emit setGridValues( double( ui->dsbGridXStep->value() ), float( ui->dsbGridYStep->value() ),
                       float( ui->dsbGridXStepCoarse->value() ), float( ui->dsbGridYStepCoarse->value() ),
@@ -1412,6 +1559,10 @@ void SettingsDialog::on_rbCrsGuidanceTransverseMercator_toggled( bool checked )
   geographicConvertionWrapperGuidance->useTM = checked;
 }
 
+void SettingsDialog::on_cbCrsGuidanceFastProjection_toggled( bool checked ) {
+  geographicConvertionWrapperGuidance->useFastProjection = checked;
+}
+
 void SettingsDialog::on_pbSaveAll_clicked() {
   // select all items, so everything gets saved
   {
@@ -1725,7 +1876,9 @@ void SettingsDialog::on_dsbGamma_valueChanged( double arg1 ) {
   settings.setValue( QStringLiteral( "Qt3D/Gamma" ), arg1 );
   settings.sync();
 
-  qt3dWindow->defaultFrameGraph()->setGamma( float( arg1 ) );
+  if( qt3dWindow != nullptr ) {
+    qt3dWindow->defaultFrameGraph()->setGamma( float( arg1 ) );
+  }
 }
 
 void SettingsDialog::on_cbShowDebugOverlay_toggled( bool checked ) {
@@ -1735,9 +1888,51 @@ void SettingsDialog::on_cbShowDebugOverlay_toggled( bool checked ) {
   settings.setValue( QStringLiteral( "Qt3D/ShowDebugOverlay" ), checked );
   settings.sync();
 
-  qt3dWindow->defaultFrameGraph()->setShowDebugOverlay( checked );
+  if( qt3dWindow != nullptr ) {
+    qt3dWindow->defaultFrameGraph()->setShowDebugOverlay( checked );
+  }
 }
 
 void SettingsDialog::on_pbGammaDefault_clicked() {
   ui->dsbGamma->setValue( 2.2 );
 }
+
+void SettingsDialog::on_cbRenderOnDemand_toggled( bool checked ) {
+  QSettings settings( QStandardPaths::writableLocation( QStandardPaths::AppDataLocation ) + "/config.ini",
+                      QSettings::IniFormat );
+
+  settings.setValue( QStringLiteral( "Qt3D/RenderOnDemand" ), checked );
+  settings.sync();
+
+  setRenderPolicy();
+}
+
+void SettingsDialog::on_sbMaxFrameRate_valueChanged( int arg1 ) {
+  QSettings settings( QStandardPaths::writableLocation( QStandardPaths::AppDataLocation ) + "/config.ini",
+                      QSettings::IniFormat );
+
+  settings.setValue( QStringLiteral( "Qt3D/MaxFrameRate" ), arg1 );
+  settings.sync();
+
+  setRenderPolicy();
+}
+
+void SettingsDialog::setRenderPolicy() {
+  if( qt3dWindow != nullptr ) {
+    // with OnDemand, Qt3D only renders a frame if a transform, a buffer, the camera etc changed
+    qt3dWindow->renderSettings()->setRenderPolicy( ui->cbRenderOnDemand->isChecked() ?
+        Qt3DRender::QRenderSettings::OnDemand :
+        Qt3DRender::QRenderSettings::Always );
+
+    // Qt3D has no limit for the frame rate, but renders synchronised to the screen: swap only every n-th refresh.
+    // This is only used by the surface, when it's created, so changes take effect on the next start
+    if( !qt3dWindow->isExposed() ) {
+      const double refreshRate = qt3dWindow->screen() != nullptr ? double( qt3dWindow->screen()->refreshRate() ) : 60;
+      const int swapInterval = std::max( 1, int( std::ceil( refreshRate / ui->sbMaxFrameRate->value() - 0.01 ) ) );
+
+      QSurfaceFormat format = qt3dWindow->format();
+      format.setSwapInterval( swapInterval );
+      qt3dWindow->setFormat( format );
+    }
+  }
+}
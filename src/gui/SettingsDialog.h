@@ -68,9 +68,12 @@ class SettingsDialog : public QDialog {
 
     void emitAllConfigSignals();
 
+    bool loadConfig( const QString& fileName );
+
   signals:
     void setGrid( bool );
     void setGridValues( float, float, float, float, float, float, float, QColor, QColor );
+    void setGridProcedural( bool );
     void plannerSettingsChanged( int, double );
 
     void globalPlannerModelSetVisible( bool );
@@ -114,6 +117,7 @@ class SettingsDialog : public QDialog {
     void on_dsbGridYStepCoarse_valueChanged( double arg1 );
     void on_dsbGridCameraThreshold_valueChanged( double arg1 );
     void on_dsbGridCameraThresholdCoarse_valueChanged( double arg1 );
+    void on_cbGridProcedural_toggled( bool checked );
     void on_pbColor_clicked();
     void on_pbColorCoarse_clicked();
 
@@ -157,6 +161,7 @@ class SettingsDialog : public QDialog {
 
     void on_rbCrsSimulatorTransverseMercator_toggled( bool checked );
     void on_rbCrsGuidanceTransverseMercator_toggled( bool checked );
+    void on_cbCrsGuidanceFastProjection_toggled( bool checked );
 
     void on_pbSaveAll_clicked();
 
@@ -190,8 +195,12 @@ class SettingsDialog : public QDialog {
 
     void on_pbGammaDefault_clicked();
 
+    void on_cbRenderOnDemand_toggled( bool checked );
+    void on_sbMaxFrameRate_valueChanged( int arg1 );
+
   private:
     void saveGridValuesInSettings();
+    void setRenderPolicy();
     void savePathPlannerValuesInSettings();
 
     void setPathPlannerSettings();
@@ -0,0 +1,119 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// walks the closed boundaries formed by directed edges between indexed vertices in linear time:
+// the edges are sorted by their source vertex with a counting sort, so no maps or sets are needed
+class BoundaryWalker {
+  public:
+    using Edge = std::pair<uint32_t, uint32_t>;
+
+    // the indices of the vertices of all the boundaries, one after another; each boundary starts with
+    // the target of its first edge and ends with its first vertex, if it is closed
+    std::vector<uint32_t> vertices;
+
+    // the start of every boundary in vertices; the last one ends at vertices.size()
+    std::vector<std::size_t> starts;
+
+  public:
+    void walk( std::size_t numVertices, const std::vector<Edge>& edges ) {
+      vertices.clear();
+      starts.clear();
+      vertices.reserve( edges.size() );
+
+      // offsets of the outgoing edges of every vertex
+      std::vector<uint32_t> offsets( numVertices + 1, 0 );
+
+      for( const auto& edge : edges ) {
+        ++offsets[edge.first + 1];
+      }
+
+      for( std::size_t i = 1; i < offsets.size(); ++i ) {
+        offsets[i] += offsets[i - 1];
+      }
+
+      std::vector<uint32_t> outgoing( edges.size() );
+      std::vector<uint32_t> cursor( offsets.cbegin(), offsets.cend() - 1 );
+
+      for( uint32_t i = 0; i < uint32_t( edges.size() ); ++i ) {
+        outgoing[cursor[edges[i].first]++] = i;
+      }
+
+      // reuse cursor as the next outgoing edge to follow for every vertex
+      std::copy( offsets.cbegin(), offsets.cend() - 1, cursor.begin() );
+
+      std::vector<bool> visited( edges.size(), false );
+
+      for( uint32_t firstEdge = 0; firstEdge < uint32_t( edges.size() ); ++firstEdge ) {
+        if( visited[firstEdge] ) {
+          continue;
+        }
+
+        const uint32_t firstVertex = edges[firstEdge].first;
+        starts.push_back( vertices.size() );
+
+        uint32_t edge = firstEdge;
+
+        while( true ) {
+          visited[edge] = true;
+
+          const uint32_t vertex = edges[edge].second;
+          vertices.push_back( vertex );
+
+          if( vertex == firstVertex ) {
+            break;
+          }
+
+          // take the next unvisited edge leaving this vertex
+          bool found = false;
+
+          while( cursor[vertex] < offsets[vertex + 1] ) {
+            edge = outgoing[cursor[vertex]++];
+
+            if( !visited[edge] ) {
+              found = true;
+              break;
+            }
+          }
+
+          // open chain
+          if( !found ) {
+            break;
+          }
+        }
+      }
+    }
+
+    std::size_t numBoundaries() const {
+      return starts.size();
+    }
+
+    std::size_t beginOfBoundary( std::size_t boundary ) const {
+      return starts[boundary];
+    }
+
+    std::size_t endOfBoundary( std::size_t boundary ) const {
+      return ( boundary + 1 ) < starts.size() ? starts[boundary + 1] : vertices.size();
+    }
+};
@@ -21,69 +21,120 @@
 
 #include <QScopedPointer>
 
-CgalWorker::CgalWorker( QObject* parent ) : QObject( parent ) {
+#include <QtConcurrent/QtConcurrentMap>
 
-}
+#include <unordered_map>
+#include <unordered_set>
+#include <limits>
+#include <algorithm>
 
-void CgalWorker::alphaToPolygon( const Alpha_shape_2& A, Polygon_with_holes_2& out_poly ) {
-  using Vertex_handle = typename Alpha_shape_2::Vertex_handle;
-  using Edge = typename Alpha_shape_2::Edge;
-  using EdgeVector = std::vector<Edge>;
+#include <CGAL/spatial_sort.h>
 
-  // form vertex to vertex map
-  std::map<Vertex_handle, EdgeVector> v_edges_map;
+#include "BoundaryWalker.h"
 
-  for( auto it = A.alpha_shape_edges_begin(); it != A.alpha_shape_edges_end(); ++it ) {
-    auto edge = *it;  // edge <=> pair<face_handle, vertex id>
-    const int vid = edge.second;
-    auto v = edge.first->vertex( ( vid + 1 ) % 3 );
+namespace {
+  // a part of the points for the tiled alpha shape. Only the faces with the centroid in the core
+  // [xmin, xmax) x [ymin, ymax) belong to the tile; the points reach a margin further
+  struct AlphaTile {
+    double xmin = 0;
+    double ymin = 0;
+    double xmax = 0;
+    double ymax = 0;
+
+    // only until the alpha shape is calculated
+    std::vector<Point_2> points;
 
-    if( v_edges_map.count( v ) == 0 ) {
-      v_edges_map[v] = EdgeVector();
+    // with the whole spectrum, so a new alpha only classifies the faces again
+    std::unique_ptr<Alpha_shape_2> alphaShape;
+
+    // the edges of the tile between an interior face of it and anything else, counterclockwise
+    std::vector<std::pair<Point_2, Point_2>> boundaryEdges;
+
+    bool contains( const Alpha_shape_2::Face_handle& face ) const {
+      const double x = ( face->vertex( 0 )->point().x() + face->vertex( 1 )->point().x() + face->vertex( 2 )->point().x() ) / 3;
+      const double y = ( face->vertex( 0 )->point().y() + face->vertex( 1 )->point().y() + face->vertex( 2 )->point().y() ) / 3;
+      return x >= xmin && x < xmax && y >= ymin && y < ymax;
     }
+  };
+}
+
+struct CgalWorker::FieldPreview {
+  ATriangulation_2 triangulation;
+
+  // the last point of the previous batch, to connect it with the next one
+  bool hasLastPoint = false;
+  Point_2 lastPoint;
+
+  // find_optimal_alpha() has to search the whole spectrum, so it is only done again if the triangulation
+  // has grown by more than a tenth since the last time
+  std::size_t numVerticesOfAlpha = 0;
+  double optimalAlpha = 0;
+  double solidAlpha = 0;
+};
+
+struct CgalWorker::FieldCache {
+  // the recorded points of the revision, as sent by the FieldManager
+  uint32_t pointsRevision = 0;
+  std::vector<Point_2> recordedPoints;
+
+  // the results of the expensive stages; only valid, if calculated with the same thinning and densify settings
+  bool valid = false;
+  double minDistanceBetweenPoints = 0;
+  double distanceBetweenConnectPoints = 0;
+
+  // less than three points left or all collinear: no boundary possible
+  bool degenerate = false;
+  std::size_t pointsDropped = 0;
+  std::size_t numPointsAfterDensify = 0;
+
+  // small sets keep the alpha shape with its spectrum, big ones the densified points for the tiles
+  bool tiled = false;
+  std::unique_ptr<Alpha_shape_2> alphaShape;
+  std::vector<Point_2> points;
+
+  // the tiles with their alpha shapes; the margin of them is wide enough for all the alphas up to alphaOfTiles
+  std::vector<AlphaTile> tiles;
+  double alphaOfTiles = 0;
 
-    v_edges_map[v].push_back( edge );
+  bool alphaSpectrumKnown = false;
+  double optimalAlpha = 0;
+  double solidAlpha = 0;
+};
+
+CgalWorker::CgalWorker( QObject* parent ) : QObject( parent ), fieldCache( new FieldCache ) {
+
+}
+
+CgalWorker::~CgalWorker() = default;
+
+// forms polygons from the boundaries: the longest is the outer one, the rest are holes
+static void boundariesToPolygon( const BoundaryWalker& walker, const std::vector<Point_2>& vertices, Polygon_with_holes_2& out_poly ) {
+  if( walker.numBoundaries() == 0 ) {
+    return;
   }
 
-  // form all possible boundaries
   std::vector<Polygon_2> polies;
-  std::vector<double> lengths;
+  polies.reserve( walker.numBoundaries() );
   double max_length = 0;
   std::size_t max_id = 0;
-  std::set<Edge> existing_edges;
-
-  for( auto it = v_edges_map.cbegin(), end = v_edges_map.cend(); it != end; ++it ) {
-    if( existing_edges.count( ( *it ).second.front() ) != 0u ) {
-      continue;
-    }
-
-    auto begin_v = ( *it ).first;
-    auto next_e = ( *it ).second.front();
-    auto next_v = next_e.first->vertex( ( next_e.second + 2 ) % 3 );
 
+  for( std::size_t boundary = 0; boundary < walker.numBoundaries(); ++boundary ) {
     Polygon_2 poly;
-    poly.push_back( next_v->point() );
-
-    existing_edges.insert( next_e );
-
-    if( v_edges_map[begin_v].size() > 1 ) {
-      v_edges_map[begin_v].erase( v_edges_map[begin_v].begin() );
-    }
+    double length = 0;
 
-    double length = CGAL::squared_distance( begin_v->point(), next_v->point() );
+    const auto begin = walker.beginOfBoundary( boundary );
+    const auto end = walker.endOfBoundary( boundary );
+    const Point_2* lastPoint = nullptr;
 
-    while( next_v != begin_v && v_edges_map.count( next_v ) > 0 ) {
-      next_e = v_edges_map[next_v].front();
-      existing_edges.insert( next_e );
+    for( std::size_t i = begin; i < end; ++i ) {
+      const Point_2& point = vertices[walker.vertices[i]];
 
-      if( v_edges_map[next_v].size() > 1 ) {
-        v_edges_map[next_v].erase( v_edges_map[next_v].begin() );
+      if( lastPoint != nullptr ) {
+        length += CGAL::squared_distance( *lastPoint, point );
       }
 
-      auto t_next_v = next_e.first->vertex( ( next_e.second + 2 ) % 3 );
-      length += CGAL::squared_distance( next_v->point(), t_next_v->point() );
-      next_v = t_next_v;
-      poly.push_back( next_v->point() );
+      poly.push_back( point );
+      lastPoint = &point;
     }
 
     if( max_length < length ) {
@@ -91,29 +142,235 @@ void CgalWorker::alphaToPolygon( const Alpha_shape_2& A, Polygon_with_holes_2& o
       max_id = polies.size();
     }
 
-    polies.push_back( poly );
-    lengths.push_back( length );
+    polies.push_back( std::move( poly ) );
   }
 
   // build polygon with holes
   // the first one is outer boundary, the rest are holes
   Polygon_2 outer_poly = polies[max_id];
-  polies.erase( polies.begin() + max_id );
+  polies.erase( polies.begin() + long( max_id ) );
   out_poly = Polygon_with_holes_2( outer_poly, polies.begin(), polies.end() );
 }
 
-bool CgalWorker::returnEarly( uint32_t runNumber ) {
-  auto cgalThread = qobject_cast<CgalThread*>( thread() );
+void CgalWorker::alphaToPolygon( const Alpha_shape_2& A, Polygon_with_holes_2& out_poly ) {
+  // give the vertices on the boundary consecutive indices; they are stored in the info of the vertices
+  // and set back to unset afterwards, so no lookup table is needed
+  std::vector<Alpha_shape_2::Vertex_handle> indexedVertices;
+  std::vector<Point_2> vertices;
+  std::vector<BoundaryWalker::Edge> edges;
+
+  const std::size_t numEdgesEstimate = std::size_t( std::sqrt( double( A.number_of_vertices() ) ) ) * 8;
+  indexedVertices.reserve( numEdgesEstimate );
+  vertices.reserve( numEdgesEstimate );
+  edges.reserve( numEdgesEstimate );
+
+  auto index = [&indexedVertices, &vertices]( Alpha_shape_2::Vertex_handle v ) {
+    if( v->info().index == AlphaVertexIndex::unset ) {
+      v->info().index = uint32_t( vertices.size() );
+      vertices.push_back( v->point() );
+      indexedVertices.push_back( v );
+    }
+
+    return v->info().index;
+  };
+
+  for( auto it = A.alpha_shape_edges_begin(), end = A.alpha_shape_edges_end(); it != end; ++it ) {
+    const auto& edge = *it;  // edge <=> pair<face_handle, vertex id>
+    const int vid = edge.second;
+    const uint32_t from = index( edge.first->vertex( ( vid + 1 ) % 3 ) );
+    const uint32_t to = index( edge.first->vertex( ( vid + 2 ) % 3 ) );
+    edges.emplace_back( from, to );
+  }
+
+  for( const auto& v : indexedVertices ) {
+    v->info().index = AlphaVertexIndex::unset;
+  }
+
+  BoundaryWalker walker;
+  walker.walk( vertices.size(), edges );
+
+  boundariesToPolygon( walker, vertices, out_poly );
+}
+
+namespace {
+  struct PointHash {
+    std::size_t operator()( const Point_2& point ) const {
+      return std::hash<double>()( point.x() ) ^ ( std::hash<double>()( point.y() ) * 31 );
+    }
+  };
+}
+
+bool CgalWorker::splitIntoTiles( double alpha ) {
+  auto& cache = *fieldCache;
+  const auto& points = cache.points;
+
+  std::vector<AlphaTile>().swap( cache.tiles );
+  cache.alphaOfTiles = 0;
+
+  double xmin = std::numeric_limits<double>::max();
+  double ymin = std::numeric_limits<double>::max();
+  double xmax = std::numeric_limits<double>::lowest();
+  double ymax = std::numeric_limits<double>::lowest();
+
+  for( const auto& point : points ) {
+    xmin = std::min( xmin, point.x() );
+    ymin = std::min( ymin, point.y() );
+    xmax = std::max( xmax, point.x() );
+    ymax = std::max( ymax, point.y() );
+  }
+
+  // a face with the squared circumradius alpha only depends on the points inside its circumcircle,
+  // which are at most two radii away from its centroid
+  const double margin = 2 * std::sqrt( alpha ) + 0.01;
+
+  // about two tiles per thread, but at least four margins wide, so the overlap stays small
+  const double width = xmax - xmin;
+  const double height = ymax - ymin;
+  const double numTilesWanted = std::max( 4, QThread::idealThreadCount() * 2 );
+  const double tileSize = std::max( std::sqrt( ( width * height ) / numTilesWanted ), 4 * margin );
+  const int numTilesX = std::max( 1, int( std::ceil( width / tileSize ) ) );
+  const int numTilesY = std::max( 1, int( std::ceil( height / tileSize ) ) );
+
+  std::vector<AlphaTile> tiles( std::size_t( numTilesX * numTilesY ) );
+
+  for( int y = 0; y < numTilesY; ++y ) {
+    for( int x = 0; x < numTilesX; ++x ) {
+      auto& tile = tiles[std::size_t( y * numTilesX + x )];
+      tile.xmin = ( x == 0 ) ? std::numeric_limits<double>::lowest() : xmin + x * tileSize;
+      tile.ymin = ( y == 0 ) ? std::numeric_limits<double>::lowest() : ymin + y * tileSize;
+      tile.xmax = ( x == numTilesX - 1 ) ? std::numeric_limits<double>::max() : xmin + ( x + 1 ) * tileSize;
+      tile.ymax = ( y == numTilesY - 1 ) ? std::numeric_limits<double>::max() : ymin + ( y + 1 ) * tileSize;
+    }
+  }
+
+  auto tileIndex = [tileSize]( double coordinate, double min, int numTiles ) {
+    return std::min( std::max( int( std::floor( ( coordinate - min ) / tileSize ) ), 0 ), numTiles - 1 );
+  };
+
+  for( const auto& point : points ) {
+    const int x0 = tileIndex( point.x() - margin, xmin, numTilesX );
+    const int x1 = tileIndex( point.x() + margin, xmin, numTilesX );
+    const int y0 = tileIndex( point.y() - margin, ymin, numTilesY );
+    const int y1 = tileIndex( point.y() + margin, ymin, numTilesY );
+
+    for( int y = y0; y <= y1; ++y ) {
+      for( int x = x0; x <= x1; ++x ) {
+        tiles[std::size_t( y * numTilesX + x )].points.push_back( point );
+      }
+    }
+  }
+
+  QtConcurrent::blockingMap( tiles, [this]( AlphaTile & tile ) {
+    if( tile.points.size() >= 3 && !cancellationToken.isCancelled() ) {
+      tile.alphaShape.reset( new Alpha_shape_2( tile.points.begin(), tile.points.end(),
+                             Epick::FT( 0 ),
+                             Alpha_shape_2::REGULARIZED ) );
+    }
+
+    std::vector<Point_2>().swap( tile.points );
+  } );
+
+  // some of the tiles are missing, so don't keep them
+  if( cancellationToken.isCancelled() ) {
+    return false;
+  }
+
+  cache.tiles.swap( tiles );
+  cache.alphaOfTiles = alpha;
+  return true;
+}
+
+void CgalWorker::tiledAlphaToPolygon( double alpha, Polygon_with_holes_2& out_poly ) {
+  auto& cache = *fieldCache;
+
+  // the tiles are only split and triangulated again, if the margin is too small for the new alpha.
+  // They are made wide enough for the solid alpha too, so switching between optimal and solid reuses them
+  if( cache.tiles.empty() || alpha > cache.alphaOfTiles ) {
+    const double alphaOfTiles = cache.alphaSpectrumKnown ? std::max( alpha, cache.solidAlpha + 0.1 ) : alpha;
+
+    if( !splitIntoTiles( alphaOfTiles ) ) {
+      return;
+    }
+  }
+
+  auto& tiles = cache.tiles;
+
+  QtConcurrent::blockingMap( tiles, [this, alpha]( AlphaTile & tile ) {
+    tile.boundaryEdges.clear();
+
+    if( tile.alphaShape && !cancellationToken.isCancelled() ) {
+      auto& alphaShape = *tile.alphaShape;
+      alphaShape.set_alpha( Epick::FT( alpha ) );
+
+      auto isInteriorFaceOfTile = [&alphaShape, &tile]( const Alpha_shape_2::Face_handle & face ) {
+        return !alphaShape.is_infinite( face ) &&
+               alphaShape.classify( face ) == Alpha_shape_2::INTERIOR &&
+               tile.contains( face );
+      };
+
+      for( auto face = alphaShape.finite_faces_begin(), end = alphaShape.finite_faces_end(); face != end; ++face ) {
+        if( isInteriorFaceOfTile( face ) ) {
+          for( int i = 0; i < 3; ++i ) {
+            if( !isInteriorFaceOfTile( face->neighbor( i ) ) ) {
+              tile.boundaryEdges.emplace_back( face->vertex( ( i + 1 ) % 3 )->point(), face->vertex( ( i + 2 ) % 3 )->point() );
+            }
+          }
+        }
+      }
+    }
+  } );
+
+  if( cancellationToken.isCancelled() ) {
+    return;
+  }
+
+  // stitch the tiles: an edge between the faces of two tiles is found in both of them, once in each direction
+  std::unordered_map<Point_2, uint32_t, PointHash> indexOfPoint;
+  std::vector<Point_2> vertices;
+  std::vector<BoundaryWalker::Edge> edges;
 
-  if( cgalThread != nullptr ) {
-    QMutexLocker lock( &cgalThread->mutex );
+  auto index = [&indexOfPoint, &vertices]( const Point_2 & point ) {
+    auto result = indexOfPoint.emplace( point, uint32_t( vertices.size() ) );
 
-    if( runNumber < cgalThread->runNumber ) {
-      return true;
+    if( result.second ) {
+      vertices.push_back( point );
+    }
+
+    return result.first->second;
+  };
+
+  for( const auto& tile : tiles ) {
+    for( const auto& edge : tile.boundaryEdges ) {
+      edges.emplace_back( index( edge.first ), index( edge.second ) );
     }
   }
 
-  return false;
+  auto key = []( uint32_t from, uint32_t to ) {
+    return ( uint64_t( from ) << 32 ) | uint64_t( to );
+  };
+
+  std::unordered_set<uint64_t> existingEdges;
+  existingEdges.reserve( edges.size() );
+
+  for( const auto& edge : edges ) {
+    existingEdges.insert( key( edge.first, edge.second ) );
+  }
+
+  edges.erase( std::remove_if( edges.begin(), edges.end(), [&existingEdges, &key]( const BoundaryWalker::Edge & edge ) {
+    return existingEdges.count( key( edge.second, edge.first ) ) != 0;
+  } ), edges.end() );
+
+  BoundaryWalker walker;
+  walker.walk( vertices.size(), edges );
+
+  boundariesToPolygon( walker, vertices, out_poly );
+}
+
+void CgalWorker::reportProgress( int percent ) {
+  if( percent != lastProgress ) {
+    lastProgress = percent;
+    emit fieldOptimitionProgress( percent );
+  }
 }
 
 bool CgalWorker::isCollinear( std::vector<Point_2>* pointsPointer, bool emitSignal ) {
@@ -134,28 +391,93 @@ bool CgalWorker::isCollinear( std::vector<Point_2>* pointsPointer, bool emitSign
   return collinearity;
 }
 
+// splits [0, size) into ranges for QtConcurrent; a few more than threads, so the load is balanced
+static std::vector<std::pair<std::size_t, std::size_t>> splitIntoRanges( std::size_t size ) {
+  std::vector<std::pair<std::size_t, std::size_t>> ranges;
+
+  const std::size_t numRanges = std::size_t( std::max( 1, QThread::idealThreadCount() * 4 ) );
+  const std::size_t sizeOfRange = std::max( std::size_t( 4096 ), ( size + numRanges - 1 ) / numRanges );
+
+  for( std::size_t begin = 0; begin < size; begin += sizeOfRange ) {
+    ranges.emplace_back( begin, std::min( size, begin + sizeOfRange ) );
+  }
+
+  return ranges;
+}
+
 void CgalWorker::connectPoints( std::vector<Point_2>* pointsPointer, double distanceBetweenConnectPoints, bool emitSignal ) {
   if( distanceBetweenConnectPoints > 0 && pointsPointer->size() >= 2 ) {
+    const std::vector<Point_2>& points = *pointsPointer;
+    const std::size_t numSegments = points.size() - 1;
 
-    for( auto last = pointsPointer->cbegin(), it = pointsPointer->cbegin() + 1, end = pointsPointer->cend();
-         it != end;
-         ++it, ++last ) {
-      const double distance = std::sqrt( CGAL::squared_distance( *last, *it ) );
+    // number of points between the points of every segment
+    auto numPointsOfSegment = [&points, distanceBetweenConnectPoints]( std::size_t segment ) -> std::size_t {
+      const double distance = std::sqrt( CGAL::squared_distance( points[segment], points[segment + 1] ) );
 
       if( ( distance - 0.01 ) > distanceBetweenConnectPoints ) {
-        std::size_t numPoints = std::size_t( distance / distanceBetweenConnectPoints );
+        std::size_t numPoints = std::min( std::size_t( distance / distanceBetweenConnectPoints ), std::size_t( 1000 ) );
+        return numPoints > 2 ? numPoints - 2 : 0;
+      }
+
+      return 0;
+    };
+
+    auto ranges = splitIntoRanges( numSegments );
+
+    // first pass: count the new points of every segment; offsets[i + 1] is the count of segment i
+    std::vector<std::size_t> offsets( numSegments + 1, 0 );
+
+    QtConcurrent::blockingMap( ranges, [this, &offsets, &numPointsOfSegment]( const std::pair<std::size_t, std::size_t>& range ) {
+      if( cancellationToken.isCancelled() ) {
+        return;
+      }
 
-        if( numPoints > 1000 ) {
-          numPoints = 1000;
+      for( std::size_t segment = range.first; segment < range.second; ++segment ) {
+        offsets[segment + 1] = numPointsOfSegment( segment );
+      }
+    } );
+
+    if( cancellationToken.isCancelled() ) {
+      return;
+    }
+
+    for( std::size_t i = 1; i < offsets.size(); ++i ) {
+      offsets[i] += offsets[i - 1];
+    }
+
+    if( offsets.back() != 0 ) {
+      // second pass: fill the preallocated buffer; the recorded points come first, followed by the new ones
+      std::vector<Point_2> result( points.size() + offsets.back() );
+      std::copy( points.cbegin(), points.cend(), result.begin() );
+
+      const std::size_t numRecordedPoints = points.size();
+
+      QtConcurrent::blockingMap( ranges, [this, &points, &offsets, &result, numRecordedPoints]( const std::pair<std::size_t, std::size_t>& range ) {
+        if( cancellationToken.isCancelled() ) {
+          return;
         }
 
-        CGAL::Points_on_segment_2< Epick::Point_2 > pointGenerator( *last, *it, numPoints );
+        for( std::size_t segment = range.first; segment < range.second; ++segment ) {
+          const std::size_t numPoints = offsets[segment + 1] - offsets[segment];
+
+          if( numPoints != 0 ) {
+            const Point_2& from = points[segment];
+            const Vector_2 step = ( points[segment + 1] - from ) / double( numPoints + 1 );
 
-        for( std::size_t i = 1; i < ( numPoints - 1 ); ++i ) {
-          pointsPointer->push_back( *pointGenerator );
-          ++pointGenerator;
+            auto out = result.begin() + long( numRecordedPoints + offsets[segment] );
+
+            for( std::size_t i = 1; i <= numPoints; ++i, ++out ) {
+              *out = from + step * double( i );
+            }
+          }
         }
+      } );
+
+      if( cancellationToken.isCancelled() ) {
+        return;
       }
+
+      pointsPointer->swap( result );
     }
   }
 
@@ -164,6 +486,40 @@ void CgalWorker::connectPoints( std::vector<Point_2>* pointsPointer, double dist
   }
 }
 
+std::size_t CgalWorker::thinPoints( std::vector<Point_2>* pointsPointer, double minDistanceBetweenPoints ) {
+  if( minDistanceBetweenPoints <= 0 || pointsPointer->size() < 3 ) {
+    return 0;
+  }
+
+  const double factor = 1 / minDistanceBetweenPoints;
+
+  std::unordered_set<uint64_t> occupiedCells;
+  occupiedCells.reserve( pointsPointer->size() );
+
+  // same as std::remove_if(), but checks the cancellation token every 64k points
+  auto newEnd = pointsPointer->begin();
+
+  for( auto it = pointsPointer->begin(), end = pointsPointer->end(); it != end; ++it ) {
+    if( ( std::distance( pointsPointer->begin(), it ) & 0xffff ) == 0 && cancellationToken.isCancelled() ) {
+      return 0;
+    }
+
+    const auto x = int32_t( std::floor( it->x() * factor ) );
+    const auto y = int32_t( std::floor( it->y() * factor ) );
+    const uint64_t key = ( uint64_t( uint32_t( x ) ) << 32 ) | uint64_t( uint32_t( y ) );
+
+    // keep the point, if the cell is not yet occupied
+    if( occupiedCells.insert( key ).second ) {
+      *newEnd++ = *it;
+    }
+  }
+
+  const auto pointsDropped = std::size_t( std::distance( newEnd, pointsPointer->end() ) );
+  pointsPointer->erase( newEnd, pointsPointer->end() );
+
+  return pointsDropped;
+}
+
 void CgalWorker::simplifyPolyline( std::vector<Point_2>* pointsPointer, double maxDeviation ) {
   PS::Squared_distance_cost cost;
 
@@ -184,89 +540,305 @@ void CgalWorker::simplifyPolygon( Polygon_with_holes_2* out_poly, double maxDevi
   }
 }
 
+static double alphaOfType( FieldsOptimitionToolbar::AlphaType alphaType, double optimalAlpha, double solidAlpha, double customAlpha ) {
+  switch( alphaType ) {
+    default:
+    case FieldsOptimitionToolbar::AlphaType::Optimal:
+      return optimalAlpha + 0.1;
+
+    case FieldsOptimitionToolbar::AlphaType::Solid:
+      return solidAlpha + 0.1;
+
+    case FieldsOptimitionToolbar::AlphaType::Custom:
+      return customAlpha;
+  }
+}
+
+void CgalWorker::estimateAlpha( const std::vector<Point_2>& points, double& optimalAlpha, double& solidAlpha ) {
+  // thin the points with a coarser and coarser grid, until a single alpha shape of them is cheap
+  std::vector<Point_2> sample( points );
+  double minDistanceBetweenPoints = 0.5;
+
+  while( sample.size() > maxPointsForAlphaEstimation ) {
+    if( cancellationToken.isCancelled() ) {
+      return;
+    }
+
+    thinPoints( &sample, minDistanceBetweenPoints );
+    minDistanceBetweenPoints *= 2;
+  }
+
+  Alpha_shape_2 alphaShape( sample.begin(), sample.end(),
+                            Epick::FT( 0 ),
+                            Alpha_shape_2::REGULARIZED );
+
+  optimalAlpha = CGAL::to_double( *alphaShape.find_optimal_alpha( 1 ) );
+  solidAlpha = CGAL::to_double( alphaShape.find_alpha_solid() );
+}
+
+bool CgalWorker::prepareFieldCache( double minDistanceBetweenPoints, double distanceBetweenConnectPoints ) {
+  auto& cache = *fieldCache;
+  cache.valid = false;
+  cache.minDistanceBetweenPoints = minDistanceBetweenPoints;
+  cache.distanceBetweenConnectPoints = distanceBetweenConnectPoints;
+  cache.alphaShape.reset();
+  std::vector<Point_2>().swap( cache.points );
+  std::vector<AlphaTile>().swap( cache.tiles );
+  cache.alphaOfTiles = 0;
+  cache.alphaSpectrumKnown = false;
+
+  std::vector<Point_2> points( cache.recordedPoints );
+
+  cache.pointsDropped = thinPoints( &points, minDistanceBetweenPoints );
+
+  if( cancellationToken.isCancelled() ) {
+    return false;
+  }
+
+  reportProgress( 5 );
+
+  // check for collinearity: if all points are collinear, you can't calculate a triangulation and it crashes
+  cache.degenerate = points.size() < 3 || isCollinear( &points );
+
+  if( !cache.degenerate ) {
+    connectPoints( &points, distanceBetweenConnectPoints );
+
+    if( cancellationToken.isCancelled() ) {
+      return false;
+    }
+
+    reportProgress( 10 );
+
+    cache.numPointsAfterDensify = points.size();
+
+    // big point sets are split into tiles, which are triangulated in parallel once and kept for the next alphas
+    cache.tiled = ( points.size() >= minPointsForTiles ) && ( QThread::idealThreadCount() > 1 );
+
+    if( cache.tiled ) {
+      cache.points.swap( points );
+    } else {
+      // insert the points in spatially sorted chunks instead of all at once, to check the token in between
+      ATriangulation_2 triangulation;
+      CGAL::spatial_sort( points.begin(), points.end() );
+
+      ATriangulation_2::Face_handle hint;
+
+      for( std::size_t i = 0, end = points.size(); i < end; ++i ) {
+        if( ( i & 0xfff ) == 0 ) {
+          if( cancellationToken.isCancelled() ) {
+            return false;
+          }
+
+          reportProgress( 10 + int( 50 * i / end ) );
+        }
+
+        hint = triangulation.insert( points[i], hint )->face();
+      }
+
+      // the triangulation is swapped into the alpha shape
+      cache.alphaShape.reset( new Alpha_shape_2( triangulation, Epick::FT( 0 ), Alpha_shape_2::REGULARIZED ) );
+
+      if( cancellationToken.isCancelled() ) {
+        return false;
+      }
+
+      reportProgress( 60 );
+
+      // find_optimal_alpha() runs through the whole spectrum in one go; it can only be cancelled before and after
+      cache.optimalAlpha = CGAL::to_double( *cache.alphaShape->find_optimal_alpha( 1 ) );
+      cache.solidAlpha = CGAL::to_double( cache.alphaShape->find_alpha_solid() );
+
+      if( cancellationToken.isCancelled() ) {
+        return false;
+      }
+
+      cache.alphaSpectrumKnown = true;
+    }
+  }
+
+  cache.valid = true;
+  return true;
+}
+
 void CgalWorker::fieldOptimitionWorker( uint32_t runNumber,
+                                        uint32_t pointsRevision,
                                         std::vector<Point_2>* pointsPointer,
                                         FieldsOptimitionToolbar::AlphaType alphaType,
                                         double customAlpha,
                                         double maxDeviation,
-                                        double distanceBetweenConnectPoints ) {
+                                        double distanceBetweenConnectPoints,
+                                        double minDistanceBetweenPoints ) {
+
+  QScopedPointer<std::vector<Point_2>> newPoints( pointsPointer );
+  auto& cache = *fieldCache;
 
-  QScopedPointer<std::vector<Point_2>> points( pointsPointer );
+  // keep the new points, even if this run gets cancelled: the next one might only change the settings
+  if( newPoints ) {
+    cache.pointsRevision = pointsRevision;
+    cache.recordedPoints.swap( *newPoints );
+    cache.valid = false;
+  }
 
-  if( returnEarly( runNumber ) ) {
+  if( cache.pointsRevision != pointsRevision ) {
+    qWarning() << "CgalWorker::fieldOptimitionWorker: no points for revision" << pointsRevision;
     return;
   }
 
-  double numPointsRecorded = double( points->size() );
+  // without a CgalThread (the benchmark calls the worker directly), the run can't be cancelled
+  auto cgalThread = qobject_cast<CgalThread*>( thread() );
+  cancellationToken = ( cgalThread != nullptr ) ? CgalCancellationToken( &cgalThread->runNumber, runNumber ) : CgalCancellationToken();
 
-  // check for collinearity: if all points are collinear, you can't calculate a triangulation and it crashes
-  if( !isCollinear( pointsPointer ) ) {
+  if( cancellationToken.isCancelled() ) {
+    return;
+  }
 
-    connectPoints( pointsPointer, distanceBetweenConnectPoints );
+  reportProgress( 0 );
 
-    if( returnEarly( runNumber ) ) {
+  // only thinning and densifying change the triangulation; a new alpha or deviation starts with the cached one
+  if( !cache.valid ||
+      cache.minDistanceBetweenPoints != minDistanceBetweenPoints ||
+      cache.distanceBetweenConnectPoints != distanceBetweenConnectPoints ) {
+    if( !prepareFieldCache( minDistanceBetweenPoints, distanceBetweenConnectPoints ) ) {
       return;
     }
+  }
 
-    Alpha_shape_2 alphaShape( points->begin(), points->end(),
-                              Epick::FT( 0 ),
-                              Alpha_shape_2::REGULARIZED );
+  if( cache.degenerate ) {
+    reportProgress( 100 );
+    return;
+  }
 
-    if( returnEarly( runNumber ) ) {
-      return;
-    }
+  auto out_poly = std::make_shared<Polygon_with_holes_2>();
+  double alpha = 0;
 
-    double optimalAlpha = CGAL::to_double( *alphaShape.find_optimal_alpha( 1 ) );
-    double solidAlpha = CGAL::to_double( alphaShape.find_alpha_solid() );
+  if( cache.tiled ) {
+    if( alphaType != FieldsOptimitionToolbar::AlphaType::Custom && !cache.alphaSpectrumKnown ) {
+      estimateAlpha( cache.points, cache.optimalAlpha, cache.solidAlpha );
 
-    emit alphaChanged( optimalAlpha, solidAlpha );
+      if( cancellationToken.isCancelled() ) {
+        return;
+      }
 
-    if( returnEarly( runNumber ) ) {
-      return;
+      cache.alphaSpectrumKnown = true;
     }
 
-    switch( alphaType ) {
-      default:
-      case FieldsOptimitionToolbar::AlphaType::Optimal:
-        alphaShape.set_alpha( optimalAlpha + 0.1 );
-        break;
+    reportProgress( 20 );
 
-      case FieldsOptimitionToolbar::AlphaType::Solid:
-        alphaShape.set_alpha( solidAlpha + 0.1 );
-        break;
+    alpha = alphaOfType( alphaType, cache.optimalAlpha, cache.solidAlpha, customAlpha );
+    tiledAlphaToPolygon( alpha, *out_poly );
+  } else {
+    reportProgress( 75 );
 
-      case FieldsOptimitionToolbar::AlphaType::Custom:
-        alphaShape.set_alpha( customAlpha );
-        break;
-    }
+    alpha = alphaOfType( alphaType, cache.optimalAlpha, cache.solidAlpha, customAlpha );
+    cache.alphaShape->set_alpha( alpha );
 
-    if( returnEarly( runNumber ) ) {
-      return;
-    }
+    alphaToPolygon( *cache.alphaShape, *out_poly );
+  }
 
-    auto out_poly = new Polygon_with_holes_2();
+  if( cancellationToken.isCancelled() ) {
+    return;
+  }
 
-    alphaToPolygon( alphaShape, *out_poly );
+  if( cache.alphaSpectrumKnown ) {
+    emit alphaChanged( cache.optimalAlpha, cache.solidAlpha, cache.tiled );
+  }
 
-    if( returnEarly( runNumber ) ) {
-      return;
-    }
+  if( out_poly->outer_boundary().size() < 3 ) {
+    reportProgress( 100 );
+    return;
+  }
 
-    simplifyPolygon( out_poly, maxDeviation );
+  reportProgress( 85 );
 
-    if( returnEarly( runNumber ) ) {
-      return;
-    }
+  simplifyPolygon( out_poly.get(), maxDeviation );
 
-    // traverse the vertices and the edges
-    {
-      CGAL::set_pretty_mode( std::cout );
+  if( cancellationToken.isCancelled() ) {
+    return;
+  }
 
-      emit fieldStatisticsChanged( numPointsRecorded, double( points->size() ), double( out_poly->outer_boundary().size() ) );
-    }
+  emit fieldStatisticsChanged( double( cache.recordedPoints.size() ), double( cache.numPointsAfterDensify ),
+                               double( out_poly->outer_boundary().size() ), double( cache.pointsDropped ) );
+
+  emit alphaShapeFinished( out_poly, alpha );
+
+  reportProgress( 100 );
+}
+
+void CgalWorker::fieldPreviewWorker( uint32_t generation,
+                                     std::vector<Point_2>* newPointsPointer,
+                                     FieldsOptimitionToolbar::AlphaType alphaType,
+                                     double customAlpha,
+                                     double maxDeviation,
+                                     double distanceBetweenConnectPoints,
+                                     double minDistanceBetweenPoints ) {
+  QScopedPointer<std::vector<Point_2>> newPoints( newPointsPointer );
+
+  // the preview is never cancelled
+  cancellationToken = CgalCancellationToken();
+
+  auto out_poly = std::make_shared<Polygon_with_holes_2>();
+
+  if( newPoints->empty() ) {
+    emit fieldPreviewFinished( out_poly, generation );
+    return;
+  }
+
+  if( !fieldPreview ) {
+    fieldPreview.reset( new FieldPreview );
+  }
+
+  // fill the gap to the last batch too
+  if( fieldPreview->hasLastPoint ) {
+    newPoints->insert( newPoints->begin(), fieldPreview->lastPoint );
+  }
+
+  thinPoints( newPointsPointer, minDistanceBetweenPoints );
+
+  fieldPreview->lastPoint = newPoints->back();
+  fieldPreview->hasLastPoint = true;
+
+  connectPoints( newPointsPointer, distanceBetweenConnectPoints );
+
+  // the range-insert sorts the points spatially, so only the new points are located and inserted
+  fieldPreview->triangulation.insert( newPoints->begin(), newPoints->end() );
 
-    emit alphaShapeFinished( std::shared_ptr<Polygon_with_holes_2>( out_poly ), CGAL::to_double( alphaShape.get_alpha() ) );
+  // all the points collinear so far -> no area
+  if( fieldPreview->triangulation.dimension() < 2 ) {
+    emit fieldPreviewFinished( out_poly, generation );
+    return;
+  }
+
+  std::size_t numVertices = fieldPreview->triangulation.number_of_vertices();
+
+  // the triangulation is swapped into the alpha shape and back after the boundary is extracted,
+  // so only the alpha values of the faces and edges are calculated again
+  Alpha_shape_2 alphaShape( fieldPreview->triangulation, Epick::FT( 0 ), Alpha_shape_2::REGULARIZED );
+
+  if( ( fieldPreview->numVerticesOfAlpha == 0 ) ||
+      ( numVertices > ( fieldPreview->numVerticesOfAlpha + fieldPreview->numVerticesOfAlpha / 10 ) ) ) {
+    fieldPreview->optimalAlpha = CGAL::to_double( *alphaShape.find_optimal_alpha( 1 ) );
+    fieldPreview->solidAlpha = CGAL::to_double( alphaShape.find_alpha_solid() );
+    fieldPreview->numVerticesOfAlpha = numVertices;
   }
+
+  alphaShape.set_alpha( alphaOfType( alphaType, fieldPreview->optimalAlpha, fieldPreview->solidAlpha, customAlpha ) );
+
+  alphaToPolygon( alphaShape, *out_poly );
+
+  fieldPreview->triangulation.swap( alphaShape );
+
+  if( out_poly->outer_boundary().size() < 3 ) {
+    emit fieldPreviewFinished( std::make_shared<Polygon_with_holes_2>(), generation );
+    return;
+  }
+
+  simplifyPolygon( out_poly.get(), maxDeviation );
+
+  emit fieldPreviewFinished( out_poly, generation );
+}
+
+void CgalWorker::resetFieldPreview() {
+  fieldPreview.reset();
 }
 
 // Without this include, qmake creates a rule to compile moc_CgalWorker.cpp standalone,
@@ -20,37 +20,78 @@
 
 #include <QObject>
 #include <QThread>
-#include <QMutex>
-#include <QMutexLocker>
 
 #include "../kinematic/cgalKernel.h"
 #include "../gui/FieldsOptimitionToolbar.h"
 
 #include <QSharedPointer>
 
+#include <memory>
+#include <atomic>
+
+// a run of the worker is cancelled as soon as a newer one is requested from the thread. The run number
+// is an atomic, so it can be checked lock free in the inner loops. A default constructed token is never cancelled
+class CgalCancellationToken {
+  public:
+    CgalCancellationToken() = default;
+    CgalCancellationToken( const std::atomic<uint32_t>* currentRunNumber, uint32_t runNumber )
+      : currentRunNumber( currentRunNumber ), runNumber( runNumber ) {}
+
+    bool isCancelled() const {
+      return currentRunNumber != nullptr && currentRunNumber->load( std::memory_order_relaxed ) > runNumber;
+    }
+
+  private:
+    const std::atomic<uint32_t>* currentRunNumber = nullptr;
+    uint32_t runNumber = 0;
+};
+
 class CgalWorker : public QObject {
     Q_OBJECT
   public:
     explicit CgalWorker( QObject* parent = nullptr );
-
+    ~CgalWorker();
 
   public slots:
+    // the triangulation and alpha spectrum are cached per revision of the points: points is only sent,
+    // if the revision changed (nullptr otherwise), so changing the alpha or deviation doesn't copy and triangulate again
     void fieldOptimitionWorker( uint32_t runNumber,
+                                uint32_t pointsRevision,
                                 std::vector<Point_2>* points,
                                 FieldsOptimitionToolbar::AlphaType alphaType,
                                 double customAlpha,
                                 double maxDeviation,
-                                double distanceBetweenConnectPoints );
+                                double distanceBetweenConnectPoints,
+                                double minDistanceBetweenPoints );
+
+    // incremental boundary for the live preview while recording: the new points are inserted into a
+    // persistent triangulation instead of triangulating all the recorded points again. Always answers with
+    // fieldPreviewFinished(), with an empty polygon if there is no area yet; generation is passed back as is
+    void fieldPreviewWorker( uint32_t generation,
+                             std::vector<Point_2>* newPoints,
+                             FieldsOptimitionToolbar::AlphaType alphaType,
+                             double customAlpha,
+                             double maxDeviation,
+                             double distanceBetweenConnectPoints,
+                             double minDistanceBetweenPoints );
+    void resetFieldPreview();
 
     bool isCollinear( std::vector<Point_2>* pointsPointer, bool emitSignal = false );
     void connectPoints( std::vector<Point_2>* pointsPointer, double distanceBetweenConnectPoints, bool emitSignal = false );
+
+    // voxel grid thinning: keeps the first point in every cell of minDistanceBetweenPoints x minDistanceBetweenPoints,
+    // the order of the remaining points doesn't change. Returns the number of dropped points
+    std::size_t thinPoints( std::vector<Point_2>* pointsPointer, double minDistanceBetweenPoints );
     void simplifyPolygon( Polygon_with_holes_2* out_poly, double maxDeviation, bool emitSignal = false );
     void simplifyPolyline( std::vector<Point_2>* pointsPointer, double maxDeviation );
 
   signals:
     void alphaShapeFinished( std::shared_ptr<Polygon_with_holes_2>, double );
-    void alphaChanged( double optimal, double solid );
-    void fieldStatisticsChanged( double, double, double );
+    // estimated: the alpha values are from a thinned out copy of the points (see estimateAlpha())
+    void alphaChanged( double optimal, double solid, bool estimated );
+    void fieldStatisticsChanged( double, double, double, double );
+    void fieldPreviewFinished( std::shared_ptr<Polygon_with_holes_2>, uint32_t generation );
+    void fieldOptimitionProgress( int percent );
 
     void isCollinearResult( bool );
     void connectPointsResult( std::vector<Point_2>* );
@@ -62,7 +103,40 @@ class CgalWorker : public QObject {
     void alphaToPolygon( const Alpha_shape_2& A,
                          Polygon_with_holes_2& out_poly );
 
-    bool returnEarly( uint32_t runNumber );
+    // the alpha shape of the cached points in overlapping tiles, calculated in parallel
+    void tiledAlphaToPolygon( double alpha,
+                              Polygon_with_holes_2& out_poly );
+
+    // splits the cached points into tiles with a margin for alphas up to alpha and triangulates them in
+    // parallel; returns false if cancelled
+    bool splitIntoTiles( double alpha );
+
+    // the optimal and solid alpha of a thinned out copy of the points, for the tiled alpha shape. The optimal
+    // alpha needs the spectrum of the whole triangulation, which is what the tiles avoid. The thinned out
+    // points need a bigger alpha, so the estimation errs on the side of a more solid shape
+    void estimateAlpha( const std::vector<Point_2>& points, double& optimalAlpha, double& solidAlpha );
+
+    // thins, densifies and triangulates the cached points; returns false if cancelled
+    bool prepareFieldCache( double minDistanceBetweenPoints, double distanceBetweenConnectPoints );
+
+    // emits fieldOptimitionProgress(), if the percentage changed
+    void reportProgress( int percent );
+
+    static constexpr std::size_t minPointsForTiles = 250000;
+    static constexpr std::size_t maxPointsForAlphaEstimation = 50000;
+
+  private:
+    // checked in the loops of the helpers; only set by fieldOptimitionWorker(), the other slots can't be cancelled
+    CgalCancellationToken cancellationToken;
+    int lastProgress = -1;
+
+    // holds the triangulation of the preview; defined in the .cpp to keep the heavy CGAL-headers out of here
+    struct FieldPreview;
+    std::unique_ptr<FieldPreview> fieldPreview;
+
+    // the expensive stages of the last fieldOptimitionWorker() run
+    struct FieldCache;
+    std::unique_ptr<FieldCache> fieldCache;
 };
 
 class CgalThread : public QThread {
@@ -73,19 +147,14 @@ class CgalThread : public QThread {
 
   public slots:
     void requestNewRunNumber() {
-      {
-        QMutexLocker lock( &mutex );
-        ++runNumber;
-      }
-      emit runNumberChanged( runNumber );
+      emit runNumberChanged( ++runNumber );
     }
 
   signals:
     void runNumberChanged( uint32_t );
 
   public:
-    QMutex mutex;
-    uint32_t runNumber = 0;
+    std::atomic<uint32_t> runNumber = { 0 };
 };
 
 Q_DECLARE_METATYPE( FieldsOptimitionToolbar::AlphaType )
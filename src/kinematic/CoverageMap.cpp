@@ -0,0 +1,793 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "CoverageMap.h"
+
+#include <QtAlgorithms>
+#include <QtEndian>
+#include <QByteArray>
+#include <QSaveFile>
+#include <QDebug>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "GeographicConvertionWrapper.h"
+
+constexpr double CoverageMap::cellSize;
+
+namespace {
+  const char magic[8] = { 'Q', 'O', 'G', 'C', 'O', 'V', 'E', 'R' };
+  constexpr quint32 version = 2;
+  constexpr qint64 headerSize = 56;
+  constexpr qint64 recordHeaderSize = 16;
+  constexpr int numWords = CoverageMap::cellsPerTile * CoverageMap::wordsPerRow;
+  constexpr int numCells = CoverageMap::cellsPerTile * CoverageMap::cellsPerTile;
+
+  enum Encoding : quint8 {
+    Raw = 0,
+    RunLength = 1
+  };
+
+  void storeF64( double value, uchar* data ) {
+    quint64 bits;
+    std::memcpy( &bits, &value, sizeof( bits ) );
+    qToLittleEndian<quint64>( bits, data );
+  }
+
+  double loadF64( const uchar* data ) {
+    const quint64 bits = qFromLittleEndian<quint64>( data );
+    double value;
+    std::memcpy( &value, &bits, sizeof( value ) );
+    return value;
+  }
+
+  // sets the cells [begin, end) of a tile
+  void setCells( quint64* bits, int begin, int end ) {
+    while( begin < end ) {
+      const int word = begin >> 6;
+      const int endInWord = std::min( end, ( word + 1 ) << 6 );
+      const int numBits = endInWord - begin;
+
+      bits[word] |= ( numBits == 64 ? ~quint64( 0 ) : ( ( quint64( 1 ) << numBits ) - 1 ) ) << ( begin & 63 );
+
+      begin = endInWord;
+    }
+  }
+
+  // run length encoding, if it is smaller than the bitmap
+  QByteArray encodeTile( const quint64* bits, quint8& encoding ) {
+    QByteArray data;
+    bool value = false;
+    quint32 run = 0;
+
+    auto appendRun = [&data]( quint32 run ) {
+      while( run >= 0x80 ) {
+        data.append( char( ( run & 0x7f ) | 0x80 ) );
+        run >>= 7;
+      }
+
+      data.append( char( run ) );
+    };
+
+    for( int i = 0; i < numWords && data.size() < numWords * 8; ++i ) {
+      const quint64 word = bits[i];
+
+      if( word == ( value ? ~quint64( 0 ) : quint64( 0 ) ) ) {
+        run += 64;
+        continue;
+      }
+
+      for( int bit = 0; bit < 64; ++bit ) {
+        if( bool( ( word >> bit ) & 1 ) != value ) {
+          appendRun( run );
+          run = 0;
+          value = !value;
+        }
+
+        ++run;
+      }
+    }
+
+    appendRun( run );
+
+    if( data.size() < numWords * 8 ) {
+      encoding = Encoding::RunLength;
+      return data;
+    }
+
+    encoding = Encoding::Raw;
+    data.resize( numWords * 8 );
+
+    for( int i = 0; i < numWords; ++i ) {
+      qToLittleEndian<quint64>( bits[i], reinterpret_cast<uchar*>( data.data() ) + i * 8 );
+    }
+
+    return data;
+  }
+
+  bool decodeTile( const QByteArray& data, quint8 encoding, quint64* bits ) {
+    const uchar* bytes = reinterpret_cast<const uchar*>( data.constData() );
+
+    if( encoding == Encoding::Raw ) {
+      if( data.size() != numWords * 8 ) {
+        return false;
+      }
+
+      for( int i = 0; i < numWords; ++i ) {
+        bits[i] = qFromLittleEndian<quint64>( bytes + i * 8 );
+      }
+
+      return true;
+    }
+
+    if( encoding == Encoding::RunLength ) {
+      int cell = 0;
+      bool value = false;
+
+      for( int i = 0, size = data.size(); i < size; ) {
+        quint32 run = 0;
+        int shift = 0;
+
+        while( i < size && shift < 32 ) {
+          const uchar byte = bytes[i++];
+          run |= quint32( byte & 0x7f ) << shift;
+          shift += 7;
+
+          if( ( byte & 0x80 ) == 0 ) {
+            break;
+          }
+        }
+
+        if( run > quint32( numCells - cell ) ) {
+          return false;
+        }
+
+        if( value ) {
+          setCells( bits, cell, cell + int( run ) );
+        }
+
+        cell += int( run );
+        value = !value;
+      }
+
+      return true;
+    }
+
+    return false;
+  }
+}
+
+CoverageMap::~CoverageMap() {
+  flush();
+}
+
+CoverageMap::Tile* CoverageMap::tileAt( qint64 tileX, qint64 tileY, bool create ) const {
+  const quint64 key = keyOfTile( tileX, tileY );
+
+  if( lastTile != nullptr && key == keyOfLastTile ) {
+    return lastTile;
+  }
+
+  auto it = tiles.find( key );
+
+  if( it == tiles.end() ) {
+    // not in memory: load it from the file or create a new one
+    std::unique_ptr<Tile> tile;
+    const auto record = records.find( key );
+
+    if( record != records.end() ) {
+      tile = loadTile( record->second );
+    }
+
+    if( tile == nullptr ) {
+      if( !create ) {
+        return nullptr;
+      }
+
+      tile.reset( new Tile );
+    }
+
+    it = tiles.emplace( key, std::move( tile ) ).first;
+  }
+
+  keyOfLastTile = key;
+  lastTile = it->second.get();
+  return lastTile;
+}
+
+void CoverageMap::fillSpan( qint64 row, qint64 beginColumn, qint64 endColumn, Counts& counts ) {
+  // the shifts round towards negative infinity, as the indices are signed
+  const qint64 tileY = row >> cellsPerTileLog2;
+  const int rowInTile = int( row & ( cellsPerTile - 1 ) );
+
+  while( beginColumn < endColumn ) {
+    const qint64 tileX = beginColumn >> cellsPerTileLog2;
+    const qint64 endInTile = std::min( endColumn, ( tileX + 1 ) << cellsPerTileLog2 );
+
+    Tile* tile = tileAt( tileX, tileY, true );
+    tile->changed = true;
+    quint64* words = tile->bits + rowInTile * wordsPerRow;
+
+    int begin = int( beginColumn & ( cellsPerTile - 1 ) );
+    const int end = int( endInTile - ( tileX << cellsPerTileLog2 ) );
+
+    while( begin < end ) {
+      const int word = begin >> 6;
+      const int endInWord = std::min( end, ( word + 1 ) << 6 );
+      const int numBits = endInWord - begin;
+
+      const quint64 mask = ( numBits == 64 ? ~quint64( 0 ) : ( ( quint64( 1 ) << numBits ) - 1 ) ) << ( begin & 63 );
+
+      counts.newCells += qPopulationCount( mask & ~words[word] );
+      counts.coveredCells += qPopulationCount( mask & words[word] );
+      words[word] |= mask;
+
+      begin = endInWord;
+    }
+
+    beginColumn = endInTile;
+  }
+}
+
+CoverageMap::Counts CoverageMap::addStrip( const Point_2& lastLeft, const Point_2& lastRight, const Point_2& left, const Point_2& right ) {
+  followOrigin();
+
+  Counts counts;
+
+  // in units of cells, the center of a cell is at +0.5
+  const double x[4] = { lastLeft.x() / cellSize, lastRight.x() / cellSize, right.x() / cellSize, left.x() / cellSize };
+  const double y[4] = { lastLeft.y() / cellSize, lastRight.y() / cellSize, right.y() / cellSize, left.y() / cellSize };
+
+  const double minY = *std::min_element( std::begin( y ), std::end( y ) );
+  const double maxY = *std::max_element( std::begin( y ), std::end( y ) );
+
+  // the rows with their center in [minY, maxY)
+  const qint64 beginRow = qint64( std::ceil( minY - 0.5 ) );
+  const qint64 endRow = qint64( std::ceil( maxY - 0.5 ) );
+
+  for( qint64 row = beginRow; row < endRow; ++row ) {
+    const double centerY = double( row ) + 0.5;
+
+    // even-odd rule with half-open edges: a crossing is counted, if centerY is in [y0, y1)
+    double crossings[4];
+    int numCrossings = 0;
+
+    for( int i = 0; i < 4; ++i ) {
+      const int j = ( i + 1 ) & 3;
+
+      if( ( y[i] <= centerY && centerY < y[j] ) || ( y[j] <= centerY && centerY < y[i] ) ) {
+        crossings[numCrossings++] = x[i] + ( centerY - y[i] ) * ( x[j] - x[i] ) / ( y[j] - y[i] );
+      }
+    }
+
+    // at most four of them
+    for( int i = 1; i < numCrossings; ++i ) {
+      for( int j = i; j > 0 && crossings[j - 1] > crossings[j]; --j ) {
+        std::swap( crossings[j - 1], crossings[j] );
+      }
+    }
+
+    for( int i = 0; i + 1 < numCrossings; i += 2 ) {
+      fillSpan( row, qint64( std::ceil( crossings[i] - 0.5 ) ), qint64( std::ceil( crossings[i + 1] - 0.5 ) ), counts );
+    }
+  }
+
+  coveredCells += counts.newCells;
+
+  return counts;
+}
+
+bool CoverageMap::isCovered( const Point_2& point ) const {
+  const qint64 column = qint64( std::floor( point.x() / cellSize ) );
+  const qint64 row = qint64( std::floor( point.y() / cellSize ) );
+
+  const Tile* tile = tileAt( column >> cellsPerTileLog2, row >> cellsPerTileLog2, false );
+
+  if( tile == nullptr ) {
+    return false;
+  }
+
+  const int columnInTile = int( column & ( cellsPerTile - 1 ) );
+  const int rowInTile = int( row & ( cellsPerTile - 1 ) );
+
+  return ( tile->bits[rowInTile * wordsPerRow + ( columnInTile >> 6 )] >> ( columnInTile & 63 ) ) & 1;
+}
+
+double CoverageMap::coverageOfSegment( const Point_2& from, const Point_2& to ) const {
+  const double length = std::sqrt( CGAL::squared_distance( from, to ) );
+  const int numSamples = std::max( 1, int( std::ceil( length / ( cellSize / 2 ) ) ) );
+
+  int numCovered = 0;
+
+  for( int i = 0; i < numSamples; ++i ) {
+    const double t = ( double( i ) + 0.5 ) / numSamples;
+
+    if( isCovered( Point_2( from.x() + ( to.x() - from.x() ) * t, from.y() + ( to.y() - from.y() ) * t ) ) ) {
+      ++numCovered;
+    }
+  }
+
+  return double( numCovered ) / numSamples;
+}
+
+void CoverageMap::clear() {
+  tiles.clear();
+  lastTile = nullptr;
+  coveredCells = 0;
+
+  records.clear();
+  sizeOfRecords = 0;
+
+  if( file.isOpen() ) {
+    file.resize( 0 );
+    headerWritten = false;
+  }
+}
+
+bool CoverageMap::setFile( const QString& fileName, GeographicConvertionWrapper* tmw ) {
+  flush();
+
+  file.close();
+  tiles.clear();
+  lastTile = nullptr;
+  coveredCells = 0;
+  records.clear();
+  sizeOfRecords = 0;
+  headerWritten = false;
+  this->tmw = tmw;
+
+  if( fileName.isEmpty() ) {
+    return true;
+  }
+
+  file.setFileName( fileName );
+
+  if( !file.open( QIODevice::ReadWrite ) ) {
+    qWarning() << "CoverageMap::setFile: can't open" << fileName;
+    return false;
+  }
+
+  // a new file gets its header with the first flush()
+  if( file.size() == 0 ) {
+    return true;
+  }
+
+  const QByteArray header = file.read( headerSize );
+  const uchar* data = reinterpret_cast<const uchar*>( header.constData() );
+
+  if( header.size() != headerSize ||
+      std::memcmp( data, magic, sizeof( magic ) ) != 0 ||
+      qFromLittleEndian<quint32>( data + 8 ) == 0 || qFromLittleEndian<quint32>( data + 8 ) > version ||
+      qFromLittleEndian<quint32>( data + 12 ) != quint32( cellsPerTile ) ||
+      loadF64( data + 16 ) != cellSize ) {
+    qWarning() << "CoverageMap::setFile:" << fileName << "is no coverage map";
+    file.close();
+    return false;
+  }
+
+  headerWritten = true;
+  originLatitude = loadF64( data + 24 );
+  originLongitude = loadF64( data + 32 );
+  originHeight = loadF64( data + 40 );
+  originUseTM = qFromLittleEndian<quint32>( data + 48 ) != 0;
+
+  // the records carry the number of their covered cells
+  indexRecords();
+
+  // ...except in version 1: count them without keeping the tiles
+  if( qFromLittleEndian<quint32>( data + 8 ) == 1 ) {
+    coveredCells = 0;
+
+    for( const auto& record : records ) {
+      const auto tile = loadTile( record.second );
+
+      if( tile != nullptr ) {
+        for( const auto word : tile->bits ) {
+          coveredCells += qPopulationCount( word );
+        }
+      }
+    }
+  }
+
+  if( tmw != nullptr && !tmw->isOriginSet() ) {
+    tmw->useTM = originUseTM;
+    tmw->Reset( originLatitude, originLongitude, originHeight );
+  }
+
+  followOrigin();
+
+  return true;
+}
+
+bool CoverageMap::followOrigin() {
+  if( !headerWritten || tmw == nullptr || !tmw->isOriginSet() ) {
+    return false;
+  }
+
+  // the height of the origin is left out: GeographicConvertionWrapper sets it with the first position,
+  // if it is zero, and it doesn't change the position in the plane
+  double latitude, longitude, height;
+  tmw->getOrigin( latitude, longitude, height );
+
+  if( latitude == originLatitude && longitude == originLongitude && tmw->useTM == originUseTM ) {
+    return false;
+  }
+
+  reproject();
+  return true;
+}
+
+bool CoverageMap::writeHeader() {
+  if( tmw == nullptr || !tmw->isOriginSet() ) {
+    return false;
+  }
+
+  uchar header[headerSize] = {};
+  std::memcpy( header, magic, sizeof( magic ) );
+  qToLittleEndian<quint32>( version, header + 8 );
+  qToLittleEndian<quint32>( quint32( cellsPerTile ), header + 12 );
+  storeF64( cellSize, header + 16 );
+
+  double latitude, longitude, height;
+  tmw->getOrigin( latitude, longitude, height );
+  originLatitude = latitude;
+  originLongitude = longitude;
+  originHeight = height;
+  originUseTM = tmw->useTM;
+  storeF64( latitude, header + 24 );
+  storeF64( longitude, header + 32 );
+  storeF64( height, header + 40 );
+  qToLittleEndian<quint32>( tmw->useTM ? 1 : 0, header + 48 );
+
+  file.seek( 0 );
+  headerWritten = file.write( reinterpret_cast<const char*>( header ), headerSize ) == headerSize;
+  return headerWritten;
+}
+
+void CoverageMap::indexRecords() {
+  const qint64 size = file.size();
+  qint64 offset = headerSize;
+
+  while( offset + recordHeaderSize <= size ) {
+    file.seek( offset );
+    const QByteArray recordHeader = file.read( recordHeaderSize );
+    const uchar* data = reinterpret_cast<const uchar*>( recordHeader.constData() );
+    const quint32 sizeOfData = qFromLittleEndian<quint32>( data + 12 );
+
+    // a record cut off by a crash while writing
+    if( recordHeader.size() != recordHeaderSize || offset + recordHeaderSize + sizeOfData > size ) {
+      break;
+    }
+
+    const quint64 key = keyOfTile( qFromLittleEndian<qint32>( data ), qFromLittleEndian<qint32>( data + 4 ) );
+    const auto record = records.find( key );
+
+    if( record != records.end() ) {
+      sizeOfRecords -= recordHeaderSize + record->second.size;
+      coveredCells -= record->second.numCoveredCells;
+    }
+
+    const quint32 numCoveredCells = quint32( data[9] ) | ( quint32( data[10] ) << 8 ) | ( quint32( data[11] ) << 16 );
+
+    records[key] = Record( { offset + recordHeaderSize, sizeOfData, data[8], numCoveredCells } );
+    sizeOfRecords += recordHeaderSize + sizeOfData;
+    coveredCells += numCoveredCells;
+
+    offset += recordHeaderSize + sizeOfData;
+  }
+
+  if( offset < size ) {
+    file.resize( offset );
+  }
+}
+
+std::unique_ptr<CoverageMap::Tile> CoverageMap::loadTile( const Record& record ) const {
+  std::unique_ptr<Tile> tile( new Tile );
+
+  if( !file.seek( record.offset ) || !decodeTile( file.read( record.size ), record.encoding, tile->bits ) ) {
+    qWarning() << "CoverageMap::loadTile: can't read a tile of" << file.fileName();
+    return nullptr;
+  }
+
+  return tile;
+}
+
+void CoverageMap::flush() {
+  if( !file.isOpen() || ( !headerWritten && !writeHeader() ) ) {
+    return;
+  }
+
+  followOrigin();
+  writeChangedTiles();
+}
+
+void CoverageMap::writeChangedTiles() {
+  QByteArray buffer;
+  qint64 offset = file.size();
+
+  for( auto& tile : tiles ) {
+    if( tile.second->changed ) {
+      quint8 encoding = Encoding::Raw;
+      const QByteArray data = encodeTile( tile.second->bits, encoding );
+
+      quint32 numCoveredCells = 0;
+
+      for( const auto word : tile.second->bits ) {
+        numCoveredCells += qPopulationCount( word );
+      }
+
+      uchar recordHeader[recordHeaderSize] = {};
+      qToLittleEndian<qint32>( qint32( tile.first >> 32 ), recordHeader );
+      qToLittleEndian<qint32>( qint32( tile.first & 0xffffffff ), recordHeader + 4 );
+      recordHeader[8] = encoding;
+      recordHeader[9] = uchar( numCoveredCells );
+      recordHeader[10] = uchar( numCoveredCells >> 8 );
+      recordHeader[11] = uchar( numCoveredCells >> 16 );
+      qToLittleEndian<quint32>( quint32( data.size() ), recordHeader + 12 );
+
+      buffer.append( reinterpret_cast<const char*>( recordHeader ), recordHeaderSize );
+      buffer.append( data );
+
+      auto record = records.find( tile.first );
+
+      if( record != records.end() ) {
+        sizeOfRecords -= recordHeaderSize + record->second.size;
+      }
+
+      records[tile.first] = Record( { offset + buffer.size() - data.size(), quint32( data.size() ), encoding, numCoveredCells } );
+      sizeOfRecords += recordHeaderSize + data.size();
+
+      tile.second->changed = false;
+    }
+  }
+
+  if( !buffer.isEmpty() ) {
+    file.seek( offset );
+
+    if( file.write( buffer ) != buffer.size() ) {
+      qWarning() << "CoverageMap::flush: can't write to" << file.fileName();
+    }
+
+    file.flush();
+  }
+
+  // the old records of the tiles take up most of the file
+  if( file.size() > headerSize + 2 * sizeOfRecords + 1024 * 1024 ) {
+    compact();
+  }
+}
+
+void CoverageMap::compact() {
+  const QString fileName = file.fileName();
+
+  file.seek( 0 );
+  QByteArray content = file.read( headerSize );
+  std::unordered_map<quint64, Record> newRecords;
+
+  for( const auto& record : records ) {
+    file.seek( record.second.offset - recordHeaderSize );
+    content.append( file.read( recordHeaderSize + record.second.size ) );
+    newRecords[record.first] = Record( { content.size() - qint64( record.second.size ), record.second.size, record.second.encoding, record.second.numCoveredCells } );
+  }
+
+  file.close();
+
+  QSaveFile saveFile( fileName );
+
+  if( saveFile.open( QIODevice::WriteOnly ) && saveFile.write( content ) == content.size() && saveFile.commit() ) {
+    records.swap( newRecords );
+  }
+
+  file.open( QIODevice::ReadWrite );
+}
+
+template<typename IsFar>
+void CoverageMap::unloadTiles( IsFar isFar ) {
+  if( !file.isOpen() ) {
+    return;
+  }
+
+  flush();
+
+  // only drop the tiles that made it into the file
+  if( !headerWritten ) {
+    return;
+  }
+
+  constexpr double sizeOfTile = cellsPerTile * cellSize;
+
+  for( auto it = tiles.begin(); it != tiles.end(); ) {
+    const double centerX = ( double( qint32( it->first >> 32 ) ) + 0.5 ) * sizeOfTile;
+    const double centerY = ( double( qint32( it->first & 0xffffffff ) ) + 0.5 ) * sizeOfTile;
+
+    if( !it->second->changed && isFar( centerX, centerY ) ) {
+      it = tiles.erase( it );
+    } else {
+      ++it;
+    }
+  }
+
+  lastTile = nullptr;
+}
+
+void CoverageMap::unloadTilesFarFrom( const Point_2& point, double distance ) {
+  constexpr double sizeOfTile = cellsPerTile * cellSize;
+  const double maxDistance = distance + sizeOfTile / 2;
+
+  unloadTiles( [&point, maxDistance]( double centerX, double centerY ) {
+    return std::abs( centerX - point.x() ) > maxDistance || std::abs( centerY - point.y() ) > maxDistance;
+  } );
+}
+
+void CoverageMap::unloadTilesBelow( double y ) {
+  const double halfSizeOfTile = cellsPerTile * cellSize / 2;
+
+  unloadTiles( [y, halfSizeOfTile]( double, double centerY ) {
+    return ( centerY + halfSizeOfTile ) < y;
+  } );
+}
+
+void CoverageMap::addTileOf( quint64 key, const Tile& tile, GeographicConvertionWrapper& tmwOfTile ) {
+  const double tileX = double( qint32( key >> 32 ) ) * cellsPerTile * cellSize;
+  const double tileY = double( qint32( key & 0xffffffff ) ) * cellsPerTile * cellSize;
+
+  auto convert = [&]( double x, double y ) {
+    double latitudeOfPoint, longitudeOfPoint, heightOfPoint, z;
+    tmwOfTile.Reverse( x, y, latitudeOfPoint, longitudeOfPoint, heightOfPoint );
+    tmw->Forward( latitudeOfPoint, longitudeOfPoint, x, y, z );
+    return Point_2( x, y );
+  };
+
+  // every run of covered cells in a row is added as a strip, with the transformation of the tile
+  // linearised: the two projections hardly differ inside of it
+  const Point_2 origin = convert( tileX, tileY );
+  const Vector_2 column = ( convert( tileX + cellsPerTile * cellSize, tileY ) - origin ) / double( cellsPerTile );
+  const Vector_2 row = ( convert( tileX, tileY + cellsPerTile * cellSize ) - origin ) / double( cellsPerTile );
+
+  auto pointOfCell = [&]( int columnInTile, int rowInTile ) {
+    return origin + column * double( columnInTile ) + row * double( rowInTile );
+  };
+
+  for( int rowInTile = 0; rowInTile < cellsPerTile; ++rowInTile ) {
+    const quint64* words = tile.bits + rowInTile * wordsPerRow;
+    int beginOfRun = -1;
+
+    for( int columnInTile = 0; columnInTile <= cellsPerTile; ++columnInTile ) {
+      const bool covered = columnInTile < cellsPerTile && ( ( words[columnInTile >> 6] >> ( columnInTile & 63 ) ) & 1 );
+
+      if( covered && beginOfRun < 0 ) {
+        beginOfRun = columnInTile;
+      } else if( !covered && beginOfRun >= 0 ) {
+        addStrip( pointOfCell( beginOfRun, rowInTile ), pointOfCell( columnInTile, rowInTile ),
+                  pointOfCell( beginOfRun, rowInTile + 1 ), pointOfCell( columnInTile, rowInTile + 1 ) );
+        beginOfRun = -1;
+      }
+    }
+  }
+}
+
+void CoverageMap::reproject() {
+  GeographicConvertionWrapper tmwOfFile;
+  tmwOfFile.useTM = originUseTM;
+  tmwOfFile.Reset( originLatitude, originLongitude, originHeight );
+
+  // the tiles in memory are in the old origin too
+  writeChangedTiles();
+  tiles.clear();
+  lastTile = nullptr;
+
+  // the reprojected tiles go into a map of their own, with a temporary file next to this one. The old tiles
+  // are read one by one, row by row, and the new ones are dropped from memory as soon as they are complete
+  const QString fileName = file.fileName();
+  const QString fileNameOfReprojected = fileName + QStringLiteral( ".reproject" );
+  QFile::remove( fileNameOfReprojected );
+
+  std::vector<std::pair<quint64, Record>> oldRecords( records.cbegin(), records.cend() );
+  std::sort( oldRecords.begin(), oldRecords.end(), []( const std::pair<quint64, Record> & lhs, const std::pair<quint64, Record> & rhs ) {
+    return std::make_pair( qint32( lhs.first & 0xffffffff ), qint32( lhs.first >> 32 ) ) <
+           std::make_pair( qint32( rhs.first & 0xffffffff ), qint32( rhs.first >> 32 ) );
+  } );
+
+  qint32 minTileX = std::numeric_limits<qint32>::max();
+  qint32 maxTileX = std::numeric_limits<qint32>::lowest();
+
+  for( const auto& record : oldRecords ) {
+    minTileX = std::min( minTileX, qint32( record.first >> 32 ) );
+    maxTileX = std::max( maxTileX, qint32( record.first >> 32 ) );
+  }
+
+  CoverageMap reprojected;
+  bool ok = reprojected.setFile( fileNameOfReprojected, tmw );
+
+  for( std::size_t i = 0; ok && i < oldRecords.size(); ++i ) {
+    const auto tile = loadTile( oldRecords[i].second );
+
+    if( tile != nullptr ) {
+      reprojected.addTileOf( oldRecords[i].first, *tile, tmwOfFile );
+    }
+
+    // the next old row only covers the new tiles above its lower edge
+    const qint32 tileY = qint32( oldRecords[i].first & 0xffffffff );
+
+    if( ( i + 1 ) < oldRecords.size() && qint32( oldRecords[i + 1].first & 0xffffffff ) != tileY ) {
+      constexpr double sizeOfTile = cellsPerTile * cellSize;
+      const double yOfNextRow = double( tileY + 1 ) * sizeOfTile;
+
+      double latitude, longitude, height, x, y0, y1, z;
+      tmwOfFile.Reverse( double( minTileX ) * sizeOfTile, yOfNextRow, latitude, longitude, height );
+      tmw->Forward( latitude, longitude, x, y0, z );
+      tmwOfFile.Reverse( double( maxTileX + 1 ) * sizeOfTile, yOfNextRow, latitude, longitude, height );
+      tmw->Forward( latitude, longitude, x, y1, z );
+
+      reprojected.unloadTilesBelow( std::min( y0, y1 ) - 2 * cellSize );
+    }
+  }
+
+  reprojected.flush();
+  ok &= reprojected.headerWritten || oldRecords.empty();
+  reprojected.setFile( QString(), nullptr );
+
+  // replace the file with the reprojected one like in compact(), so it is never left half written
+  file.close();
+
+  if( ok ) {
+    QFile fileOfReprojected( fileNameOfReprojected );
+    QSaveFile saveFile( fileName );
+
+    ok = fileOfReprojected.open( QIODevice::ReadOnly ) && saveFile.open( QIODevice::WriteOnly );
+
+    while( ok && !fileOfReprojected.atEnd() ) {
+      const QByteArray chunk = fileOfReprojected.read( 1024 * 1024 );
+      ok = !chunk.isEmpty() && saveFile.write( chunk ) == chunk.size();
+    }
+
+    ok = ok && saveFile.commit();
+  }
+
+  QFile::remove( fileNameOfReprojected );
+
+  records.clear();
+  sizeOfRecords = 0;
+  coveredCells = 0;
+  headerWritten = false;
+
+  if( !ok || !file.open( QIODevice::ReadWrite ) ) {
+    qWarning() << "CoverageMap::reproject: can't reproject" << fileName << "to the new origin, it is left as it is and detached";
+    return;
+  }
+
+  // the header has the new origin
+  file.seek( 0 );
+  const QByteArray header = file.read( headerSize );
+
+  if( header.size() == headerSize ) {
+    const uchar* data = reinterpret_cast<const uchar*>( header.constData() );
+    originLatitude = loadF64( data + 24 );
+    originLongitude = loadF64( data + 32 );
+    originHeight = loadF64( data + 40 );
+    originUseTM = qFromLittleEndian<quint32>( data + 48 ) != 0;
+    headerWritten = true;
+  }
+
+  // the records carry the number of their covered cells
+  indexRecords();
+}
@@ -0,0 +1,170 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QtGlobal>
+#include <QString>
+#include <QFile>
+
+#include <unordered_map>
+#include <memory>
+
+#include "../kinematic/cgalKernel.h"
+
+class GeographicConvertionWrapper;
+
+// a raster of the worked area on the CPU: the plane is divided into cells of cellSize, which are
+// covered or not. The cells are kept as bitmaps in tiles of 256x256 cells, which are only allocated
+// where something is covered. Polygons are filled with the cells whose center is inside, with
+// half-open spans, so adjacent strips (along the track and of neighbouring sections) share no cells.
+//
+// With a file set, the changed tiles are appended to it by flush() and the tiles are loaded from it
+// on the first access, so only the tiles around the vehicle have to be kept in memory. If the origin
+// of the local coordinates changes, the file is reprojected to the new one.
+//
+// layout of the file, all little-endian:
+//   header:  char magic[8] "QOGCOVER", uint32 version, uint32 cellsPerTile, double cellSize,
+//            double originLatitude, originLongitude, originHeight, uint32 useTM, uint32 reserved
+//   records: int32 tileX, int32 tileY, uint8 encoding, uint24 numCoveredCells, uint32 size, uint8 data[size]
+//            encoding 0: the bitmap as uint64 words, row by row; 1: the lengths of the alternating
+//            runs of uncovered and covered cells, as LEB128
+//   the last record of a tile is the valid one; the file is compacted, when it gets too big. In version 1,
+//   numCoveredCells was reserved, so the tiles of such a file are decoded to count the covered cells
+class CoverageMap {
+  public:
+    static constexpr double cellSize = 0.1;
+    static constexpr int cellsPerTileLog2 = 8;
+    static constexpr int cellsPerTile = 1 << cellsPerTileLog2;
+    static constexpr int wordsPerRow = cellsPerTile / 64;
+
+    struct Counts {
+      // cells, which were not covered before
+      std::size_t newCells = 0;
+      // cells, which were already covered
+      std::size_t coveredCells = 0;
+    };
+
+  public:
+    CoverageMap() = default;
+    ~CoverageMap();
+
+    // covers the strip between two consecutive positions of the edges of a section
+    Counts addStrip( const Point_2& lastLeft, const Point_2& lastRight, const Point_2& left, const Point_2& right );
+
+    bool isCovered( const Point_2& point ) const;
+
+    // the fraction of the segment, which is covered; sampled about every half cell
+    double coverageOfSegment( const Point_2& from, const Point_2& to ) const;
+
+    // clears the map and the file
+    void clear();
+
+    // writes the changes to the current file and switches to fileName; an empty one detaches the map
+    // from a file. If the origin of tmw isn't set yet, it is set to the one of the file, otherwise the
+    // file is reprojected if it differs. Returns false, if the file can't be opened or isn't a coverage map
+    bool setFile( const QString& fileName, GeographicConvertionWrapper* tmw );
+
+    // appends the changed tiles to the file
+    void flush();
+
+    // if the origin of tmw changed since the tiles in the file were made, the file is reprojected to the new
+    // one. Called by addStrip() and flush(); returns true if it reprojected
+    bool followOrigin();
+
+    // drops the tiles farther away than distance from memory; only with a file, as they would get lost otherwise
+    void unloadTilesFarFrom( const Point_2& point, double distance );
+
+    // the tiles in memory
+    std::size_t numTiles() const {
+      return tiles.size();
+    }
+
+    std::size_t numTilesInFile() const {
+      return records.size();
+    }
+
+    // all the covered cells, in memory and in the file
+    std::size_t numCoveredCells() const {
+      return coveredCells;
+    }
+
+    static double areaOfCells( std::size_t numCells ) {
+      return double( numCells ) * cellSize * cellSize;
+    }
+
+  private:
+    struct Tile {
+      quint64 bits[cellsPerTile * wordsPerRow] = {};
+      bool changed = false;
+    };
+
+    struct Record {
+      qint64 offset;
+      quint32 size;
+      quint8 encoding;
+      quint32 numCoveredCells;
+    };
+
+    static quint64 keyOfTile( qint64 tileX, qint64 tileY ) {
+      return ( quint64( quint32( tileX ) ) << 32 ) | quint64( quint32( tileY ) );
+    }
+
+    Tile* tileAt( qint64 tileX, qint64 tileY, bool create ) const;
+    std::unique_ptr<Tile> loadTile( const Record& record ) const;
+
+    bool writeHeader();
+    void indexRecords();
+    void writeChangedTiles();
+    void compact();
+
+    // rewrites the file from the origin in the header to the one of tmw
+    void reproject();
+
+    // adds the covered cells of a tile made in the coordinates of tmwOfTile
+    void addTileOf( quint64 key, const Tile& tile, GeographicConvertionWrapper& tmwOfTile );
+
+    // flushes and drops the unchanged tiles below y from memory
+    void unloadTilesBelow( double y );
+    template<typename IsFar>
+    void unloadTiles( IsFar isFar );
+
+    // sets the cells [beginColumn, endColumn) of the row
+    void fillSpan( qint64 row, qint64 beginColumn, qint64 endColumn, Counts& counts );
+
+  private:
+    mutable std::unordered_map<quint64, std::unique_ptr<Tile>> tiles;
+    std::size_t coveredCells = 0;
+
+    // the tiles in the file; the header is written with the first flush() after the origin is known
+    mutable QFile file;
+    GeographicConvertionWrapper* tmw = nullptr;
+    std::unordered_map<quint64, Record> records;
+    qint64 sizeOfRecords = 0;
+    bool headerWritten = false;
+
+    // the origin in the header, the tiles of the file are in its coordinates
+    double originLatitude = 0;
+    double originLongitude = 0;
+    double originHeight = 0;
+    bool originUseTM = true;
+
+    // most of the lookups hit the same tile as the last one
+    mutable quint64 keyOfLastTile = 0;
+    mutable Tile* lastTile = nullptr;
+};
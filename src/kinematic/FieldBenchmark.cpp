@@ -0,0 +1,328 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "FieldBenchmark.h"
+
+#include <QFile>
+#include <QTemporaryFile>
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include <random>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+
+#include "CgalWorker.h"
+#include "GeographicConvertionWrapper.h"
+#include "FieldGeoJson.h"
+#include "FieldBinary.h"
+
+int FieldBenchmark::run( const QString& recordedFile ) {
+  benchmark( QStringLiteral( "synthetic 10k" ), syntheticPoints( 10000, 500, 300 ) );
+  benchmark( QStringLiteral( "synthetic 100k" ), syntheticPoints( 100000, 500, 300 ) );
+  benchmark( QStringLiteral( "synthetic 1M" ), syntheticPoints( 1000000, 2000, 1200 ) );
+
+  benchmarkFileFormats( 1000000 );
+  benchmarkConversion( 1000000 );
+  benchmarkFastProjection( 1000000 );
+
+  if( !recordedFile.isEmpty() ) {
+    auto points = recordedPoints( recordedFile );
+
+    if( points.size() < 3 ) {
+      qWarning() << "FieldBenchmark: no raw points in" << recordedFile;
+      return 1;
+    }
+
+    benchmark( recordedFile, points );
+  }
+
+  return 0;
+}
+
+std::vector<Point_2> FieldBenchmark::syntheticPoints( std::size_t numPoints, double width, double height ) {
+  // fixed seed, so the runs are comparable
+  std::mt19937 generator( 42 );
+  std::normal_distribution<double> noise( 0, 0.02 );
+
+  const double perimeter = 2 * ( width + height );
+  const double step = perimeter * 5 / double( numPoints );
+
+  std::vector<Point_2> points;
+  points.reserve( numPoints );
+
+  // five rounds, each one an implement width further in
+  for( std::size_t i = 0; i < numPoints; ++i ) {
+    const double round = std::floor( double( i ) * step / perimeter );
+    const double inset = round * 6;
+    const double w = width - 2 * inset;
+    const double h = height - 2 * inset;
+    double s = std::fmod( double( i ) * step, perimeter ) * ( 2 * ( w + h ) ) / perimeter;
+
+    double x = inset;
+    double y = inset;
+
+    if( s < w ) {
+      x += s;
+    } else if( ( s -= w ) < h ) {
+      x += w;
+      y += s;
+    } else if( ( s -= h ) < w ) {
+      x += w - s;
+      y += h;
+    } else {
+      s -= w;
+      y += h - s;
+    }
+
+    points.emplace_back( x + noise( generator ), y + noise( generator ) );
+  }
+
+  return points;
+}
+
+std::vector<Point_2> FieldBenchmark::recordedPoints( const QString& fileName ) {
+  std::vector<Point_2> points;
+
+  QFile file( fileName );
+
+  if( !file.open( QIODevice::ReadOnly ) ) {
+    qWarning() << "FieldBenchmark: couldn't open" << fileName;
+    return points;
+  }
+
+  GeographicConvertionWrapper tmw;
+  FieldData fieldData;
+  FieldGeoJson::read( file, tmw, fieldData );
+
+  points.reserve( fieldData.points.size() );
+
+  for( const auto& point : fieldData.points ) {
+    points.emplace_back( point.x(), point.y() );
+  }
+
+  return points;
+}
+
+void FieldBenchmark::benchmark( const QString& name, const std::vector<Point_2>& points ) {
+  CgalWorker worker;
+
+  std::size_t pointsInBoundary = 0;
+  QObject::connect( &worker, &CgalWorker::alphaShapeFinished, [&pointsInBoundary]( std::shared_ptr<Polygon_with_holes_2> field, double ) {
+    pointsInBoundary = field->outer_boundary().size();
+  } );
+
+  // every run gets a new revision of the points, so nothing is cached
+  uint32_t pointsRevision = 0;
+
+  // without and with thinning
+  for( const double minDistanceBetweenPoints : { 0., 0.2 } ) {
+    qint64 best = std::numeric_limits<qint64>::max();
+
+    for( int i = 0; i < 3; ++i ) {
+      QElapsedTimer timer;
+      timer.start();
+
+      // the worker takes ownership of the points; not moved to a CgalThread, so it runs synchronously
+      worker.fieldOptimitionWorker( 0, ++pointsRevision, new std::vector<Point_2>( points ),
+                                    FieldsOptimitionToolbar::AlphaType::Optimal, 10, 0.1, 0.5, minDistanceBetweenPoints );
+
+      best = std::min( best, timer.nsecsElapsed() );
+    }
+
+    qInfo() << "FieldBenchmark:" << name << points.size() << "points, thinning" << minDistanceBetweenPoints << "m ->"
+            << pointsInBoundary << "points in boundary, best of 3:" << double( best ) / 1e6 << "ms";
+
+    // same revision, only the deviation changes: starts with the cached triangulation
+    best = std::numeric_limits<qint64>::max();
+
+    for( int i = 0; i < 3; ++i ) {
+      QElapsedTimer timer;
+      timer.start();
+
+      worker.fieldOptimitionWorker( 0, pointsRevision, nullptr,
+                                    FieldsOptimitionToolbar::AlphaType::Optimal, 10, 0.1 + 0.05 * i, 0.5, minDistanceBetweenPoints );
+
+      best = std::min( best, timer.nsecsElapsed() );
+    }
+
+    qInfo() << "FieldBenchmark:" << name << "cached, new deviation ->" << pointsInBoundary << "points in boundary, best of 3:" << double( best ) / 1e6 << "ms";
+  }
+}
+
+void FieldBenchmark::benchmarkFileFormats( std::size_t numPoints ) {
+  GeographicConvertionWrapper tmw;
+  tmw.Reset( 47.5, 8.5, 400 );
+
+  FieldData fieldData;
+  fieldData.hasPoints = true;
+
+  {
+    const auto points = syntheticPoints( numPoints, 2000, 1200 );
+    fieldData.points.reserve( points.size() );
+
+    for( const auto& point : points ) {
+      fieldData.points.emplace_back( point.x(), point.y(), 0.5 );
+    }
+  }
+
+  for( const bool binary : { false, true } ) {
+    QTemporaryFile file;
+
+    if( !file.open() ) {
+      qWarning() << "FieldBenchmark: couldn't open a temporary file";
+      return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if( binary ) {
+      FieldBinary::write( file, tmw, fieldData );
+    } else {
+      FieldGeoJson::write( file, tmw, fieldData );
+    }
+
+    file.flush();
+    const qint64 elapsedWrite = timer.nsecsElapsed();
+
+    file.seek( 0 );
+    FieldData fieldDataRead;
+
+    timer.restart();
+
+    if( binary ) {
+      FieldBinary::read( file, tmw, fieldDataRead );
+    } else {
+      FieldGeoJson::read( file, tmw, fieldDataRead );
+    }
+
+    const qint64 elapsedRead = timer.nsecsElapsed();
+
+    qInfo() << "FieldBenchmark:" << ( binary ? "binary" : "GeoJSON" ) << "with" << numPoints << "points," << file.size() / ( 1024 * 1024 ) << "MiB, write"
+            << double( elapsedWrite ) / 1e6 << "ms, read" << double( elapsedRead ) / 1e6 << "ms," << fieldDataRead.points.size() << "points read";
+  }
+}
+
+void FieldBenchmark::benchmarkConversion( std::size_t numPoints ) {
+  std::vector<GeographicConvertionWrapper::LocalPosition> localPositions( numPoints );
+  std::vector<GeographicConvertionWrapper::GeographicPosition> positions( numPoints );
+
+  {
+    const auto points = syntheticPoints( numPoints, 2000, 1200 );
+
+    for( std::size_t i = 0; i < numPoints; ++i ) {
+      localPositions[i] = { points[i].x(), points[i].y(), 0.5 };
+    }
+  }
+
+  for( const bool useTM : { true, false } ) {
+    GeographicConvertionWrapper tmw;
+    tmw.useTM = useTM;
+    tmw.Reset( 47.5, 8.5, 400 );
+
+    auto report = [numPoints, useTM]( const char* kind, qint64 nsecs ) {
+      qInfo() << "FieldBenchmark:" << ( useTM ? "TM" : "LC" ) << kind << "conversion of" << numPoints << "points:"
+              << double( nsecs ) / 1e6 << "ms," << qint64( double( numPoints ) * 1e9 / double( std::max( nsecs, qint64( 1 ) ) ) ) << "points/s";
+    };
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for( std::size_t i = 0; i < numPoints; ++i ) {
+      tmw.Reverse( localPositions[i].x, localPositions[i].y, localPositions[i].z,
+                   positions[i].latitude, positions[i].longitude, positions[i].height );
+    }
+
+    for( std::size_t i = 0; i < numPoints; ++i ) {
+      tmw.Forward( positions[i].latitude, positions[i].longitude, positions[i].height,
+                   localPositions[i].x, localPositions[i].y, localPositions[i].z );
+    }
+
+    report( "single", timer.nsecsElapsed() );
+
+    for( const bool parallel : { false, true } ) {
+      timer.restart();
+
+      tmw.Reverse( localPositions.data(), positions.data(), numPoints, true, parallel );
+      tmw.Forward( positions.data(), localPositions.data(), numPoints, true, parallel );
+
+      report( parallel ? "batch parallel" : "batch", timer.nsecsElapsed() );
+    }
+  }
+}
+
+void FieldBenchmark::benchmarkFastProjection( std::size_t numPoints ) {
+  // a track heading north-east with some noise, about 70 km long
+  std::vector<GeographicConvertionWrapper::GeographicPosition> positions( numPoints );
+  {
+    std::mt19937 generator( 42 );
+    std::uniform_real_distribution<double> noise( -1, 1 );
+
+    double latitude = 47.5;
+    double longitude = 8.5;
+
+    for( auto& position : positions ) {
+      latitude += 4e-7 + 2e-7 * noise( generator );
+      longitude += 6e-7 + 2e-7 * noise( generator );
+      position = { latitude, longitude, 400 + 20 * noise( generator ) };
+    }
+  }
+
+  for( const bool useTM : { true, false } ) {
+    GeographicConvertionWrapper tmwExact;
+    GeographicConvertionWrapper tmwFast;
+    tmwExact.useTM = tmwFast.useTM = useTM;
+    tmwFast.useFastProjection = true;
+    tmwExact.Reset( 47.5, 8.5, 400 );
+    tmwFast.Reset( 47.5, 8.5, 400 );
+
+    std::vector<GeographicConvertionWrapper::LocalPosition> exact( numPoints );
+    std::vector<GeographicConvertionWrapper::LocalPosition> fast( numPoints );
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for( std::size_t i = 0; i < numPoints; ++i ) {
+      tmwExact.Forward( positions[i].latitude, positions[i].longitude, positions[i].height, exact[i].x, exact[i].y, exact[i].z );
+    }
+
+    const qint64 elapsedExact = timer.nsecsElapsed();
+    double maxErrorBound = 0;
+
+    timer.restart();
+
+    for( std::size_t i = 0; i < numPoints; ++i ) {
+      tmwFast.Forward( positions[i].latitude, positions[i].longitude, positions[i].height, fast[i].x, fast[i].y, fast[i].z );
+      maxErrorBound = std::max( maxErrorBound, tmwFast.fastProjectionError() );
+    }
+
+    const qint64 elapsedFast = timer.nsecsElapsed();
+
+    double maxError = 0;
+
+    for( std::size_t i = 0; i < numPoints; ++i ) {
+      maxError = std::max( maxError, std::hypot( std::hypot( exact[i].x - fast[i].x, exact[i].y - fast[i].y ), exact[i].z - fast[i].z ) );
+    }
+
+    qInfo() << "FieldBenchmark:" << ( useTM ? "TM" : "LC" ) << "fast projection of" << numPoints << "fixes:"
+            << double( elapsedFast ) / double( numPoints ) << "ns/fix, exact" << double( elapsedExact ) / double( numPoints ) << "ns/fix, max error"
+            << maxError * 1000 << "mm, max error when anchoring" << maxErrorBound * 1000 << "mm";
+  }
+}
@@ -0,0 +1,55 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QString>
+
+#include <vector>
+
+#include "../kinematic/cgalKernel.h"
+
+// runs the field optimisation of CgalWorker synchronously on synthetic and recorded point clouds and prints
+// the best of three runs with a new point set and with the cached triangulation, each without and with thinning.
+// Also times the file formats, the conversion and the fast projection
+class FieldBenchmark {
+  public:
+    FieldBenchmark() {}
+
+    // recordedFile: GeoJSON as saved by FieldManager, the raw points of it are used; can be empty
+    int run( const QString& recordedFile );
+
+    // points along the border of a field of width x height meters with some noise, as recorded
+    // while driving around it several times
+    static std::vector<Point_2> syntheticPoints( std::size_t numPoints, double width, double height );
+
+    // the raw points (MultiPoint) of a GeoJSON-file
+    static std::vector<Point_2> recordedPoints( const QString& fileName );
+
+  private:
+    void benchmark( const QString& name, const std::vector<Point_2>& points );
+
+    // saves and opens a field with numPoints raw points
+    void benchmarkFileFormats( std::size_t numPoints );
+
+    // converts numPoints positions forth and back, one by one and as batch
+    void benchmarkConversion( std::size_t numPoints );
+
+    // converts a track of numPoints fixes with the fast and the exact projection
+    void benchmarkFastProjection( std::size_t numPoints );
+};
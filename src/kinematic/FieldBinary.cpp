@@ -0,0 +1,443 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "FieldBinary.h"
+
+#include <QByteArray>
+#include <QDir>
+#include <QFileInfo>
+#include <QtEndian>
+
+#include <cstring>
+#include <vector>
+
+#include "GeographicConvertionWrapper.h"
+
+namespace {
+  const char magic[8] = { 'Q', 'O', 'G', 'F', 'I', 'E', 'L', 'D' };
+  constexpr qint64 headerSize = 48;
+  constexpr qint64 sectionEntrySize = 24;
+
+  constexpr quint64 align8( quint64 size ) {
+    return ( size + 7 ) & ~quint64( 7 );
+  }
+
+  // appends little-endian values to a buffer
+  class LittleEndianBuffer {
+    public:
+      void appendU32( quint32 value ) {
+        uchar bytes[4];
+        qToLittleEndian<quint32>( value, bytes );
+        buffer.append( reinterpret_cast<const char*>( bytes ), 4 );
+      }
+
+      void appendU64( quint64 value ) {
+        uchar bytes[8];
+        qToLittleEndian<quint64>( value, bytes );
+        buffer.append( reinterpret_cast<const char*>( bytes ), 8 );
+      }
+
+      void appendF64( double value ) {
+        quint64 bits;
+        std::memcpy( &bits, &value, sizeof( bits ) );
+        appendU64( bits );
+      }
+
+      void padTo8() {
+        while( buffer.size() % 8 != 0 ) {
+          buffer.append( '\0' );
+        }
+      }
+
+    public:
+      QByteArray buffer;
+  };
+
+  quint32 loadU32( const uchar* data ) {
+    return qFromLittleEndian<quint32>( data );
+  }
+
+  quint64 loadU64( const uchar* data ) {
+    return qFromLittleEndian<quint64>( data );
+  }
+
+  double loadF64( const uchar* data ) {
+    const quint64 bits = qFromLittleEndian<quint64>( data );
+    double value;
+    std::memcpy( &value, &bits, sizeof( value ) );
+    return value;
+  }
+}
+
+bool FieldBinary::isFieldBinary( QFile& file ) {
+  return file.peek( sizeof( magic ) ) == QByteArray::fromRawData( magic, sizeof( magic ) );
+}
+
+bool FieldBinary::read( QFile& file, GeographicConvertionWrapper& tmw, FieldData& fieldData, bool withRawPoints ) {
+  // map the file if possible, so the content isn't copied
+  QByteArray content;
+  const uchar* data = nullptr;
+  qint64 size = file.size();
+  uchar* mapped = ( size > 0 ) ? file.map( 0, size ) : nullptr;
+
+  if( mapped != nullptr ) {
+    data = mapped;
+  } else {
+    content = file.readAll();
+    data = reinterpret_cast<const uchar*>( content.constData() );
+    size = content.size();
+  }
+
+  auto unmap = [&file, mapped]() {
+    if( mapped != nullptr ) {
+      file.unmap( mapped );
+    }
+  };
+
+  if( size < headerSize || std::memcmp( data, magic, sizeof( magic ) ) != 0 || loadU32( data + 8 ) < 1 ) {
+    unmap();
+    return false;
+  }
+
+  const quint32 numSections = loadU32( data + 12 );
+  const double originLatitude = loadF64( data + 16 );
+  const double originLongitude = loadF64( data + 24 );
+  const double originHeight = loadF64( data + 32 );
+  const bool useTM = loadU32( data + 40 ) != 0;
+
+  if( quint64( size ) < quint64( headerSize ) + quint64( numSections ) * sectionEntrySize ) {
+    unmap();
+    return false;
+  }
+
+  // the coordinates only have to be converted, if the origin or the projection differ
+  if( !tmw.isOriginSet() ) {
+    tmw.Reset( originLatitude, originLongitude, originHeight );
+  }
+
+  bool sameOrigin = false;
+  {
+    double latitude, longitude, height;
+    tmw.getOrigin( latitude, longitude, height );
+    sameOrigin = ( latitude == originLatitude ) && ( longitude == originLongitude ) &&
+                 ( height == originHeight ) && ( useTM == tmw.useTM );
+  }
+
+  GeographicConvertionWrapper tmwOfFile;
+  tmwOfFile.useTM = useTM;
+  tmwOfFile.Reset( originLatitude, originLongitude, originHeight );
+
+  auto convert = [&tmw, &tmwOfFile, sameOrigin]( double & x, double & y, double & z ) {
+    if( !sameOrigin ) {
+      double latitude, longitude, height;
+      tmwOfFile.Reverse( x, y, z, latitude, longitude, height );
+      tmw.Forward( latitude, longitude, height, x, y, z );
+    }
+  };
+
+  bool ok = true;
+
+  for( quint32 section = 0; section < numSections && ok; ++section ) {
+    const uchar* entry = data + headerSize + section * sectionEntrySize;
+    const quint32 type = loadU32( entry );
+    const quint64 offset = loadU64( entry + 8 );
+    const quint64 sectionSize = loadU64( entry + 16 );
+
+    if( offset > quint64( size ) || sectionSize > quint64( size ) - offset ) {
+      ok = false;
+      break;
+    }
+
+    const uchar* sectionData = data + offset;
+
+    switch( SectionType( type ) ) {
+      case SectionType::Metadata: {
+        if( sectionSize < 24 ) {
+          ok = false;
+          break;
+        }
+
+        fieldData.alpha = loadF64( sectionData );
+        fieldData.distanceBetweenConnectPoints = loadF64( sectionData + 8 );
+        fieldData.maxDeviation = loadF64( sectionData + 16 );
+      }
+      break;
+
+      case SectionType::Boundary: {
+        if( sectionSize < 8 ) {
+          ok = false;
+          break;
+        }
+
+        const quint32 numRings = loadU32( sectionData );
+        const quint64 sizeOfRingTable = align8( quint64( numRings ) * 4 );
+
+        if( sectionSize < 8 + sizeOfRingTable ) {
+          ok = false;
+          break;
+        }
+
+        quint64 numVertices = 0;
+
+        for( quint32 ring = 0; ring < numRings; ++ring ) {
+          numVertices += loadU32( sectionData + 8 + ring * 4 );
+        }
+
+        if( ( sectionSize - 8 - sizeOfRingTable ) / 16 < numVertices ) {
+          ok = false;
+          break;
+        }
+
+        auto field = std::make_shared<Polygon_with_holes_2>();
+        const uchar* vertex = sectionData + 8 + sizeOfRingTable;
+
+        for( quint32 ring = 0; ring < numRings; ++ring ) {
+          Polygon_2 poly;
+          poly.container().reserve( loadU32( sectionData + 8 + ring * 4 ) );
+
+          for( quint32 i = 0, end = loadU32( sectionData + 8 + ring * 4 ); i < end; ++i, vertex += 16 ) {
+            double x = loadF64( vertex );
+            double y = loadF64( vertex + 8 );
+            double z = 0;
+            convert( x, y, z );
+            poly.push_back( Point_2( x, y ) );
+          }
+
+          if( ring == 0 ) {
+            field->outer_boundary() = std::move( poly );
+          } else {
+            field->add_hole( std::move( poly ) );
+          }
+        }
+
+        fieldData.field = field;
+      }
+      break;
+
+      case SectionType::Points: {
+        if( !withRawPoints ) {
+          break;
+        }
+
+        if( sectionSize < 8 ) {
+          ok = false;
+          break;
+        }
+
+        const quint64 numPoints = loadU64( sectionData );
+
+        if( ( sectionSize - 8 ) / 24 < numPoints ) {
+          ok = false;
+          break;
+        }
+
+        fieldData.points.clear();
+        fieldData.points.reserve( std::size_t( numPoints ) );
+
+        if( sameOrigin ) {
+          for( const uchar* point = sectionData + 8, *end = point + numPoints * 24; point != end; point += 24 ) {
+            fieldData.points.emplace_back( loadF64( point ), loadF64( point + 8 ), loadF64( point + 16 ) );
+          }
+        } else {
+          // convert all the points at once, over the geographic coordinates
+          std::vector<GeographicConvertionWrapper::LocalPosition> localPositions( std::size_t( numPoints ) );
+          std::vector<GeographicConvertionWrapper::GeographicPosition> positions( std::size_t( numPoints ) );
+          const uchar* point = sectionData + 8;
+
+          for( auto& localPosition : localPositions ) {
+            localPosition = { loadF64( point ), loadF64( point + 8 ), loadF64( point + 16 ) };
+            point += 24;
+          }
+
+          tmwOfFile.Reverse( localPositions.data(), positions.data(), positions.size(), true, true );
+          tmw.Forward( positions.data(), localPositions.data(), positions.size(), true, true );
+
+          for( const auto& localPosition : localPositions ) {
+            fieldData.points.emplace_back( localPosition.x, localPosition.y, localPosition.z );
+          }
+        }
+
+        fieldData.hasPoints = true;
+      }
+      break;
+
+      case SectionType::Coverage: {
+        if( sectionSize < 8 || sectionSize - 8 < loadU32( sectionData ) ) {
+          ok = false;
+          break;
+        }
+
+        const QString fileName = QString::fromUtf8( reinterpret_cast<const char*>( sectionData + 8 ), int( loadU32( sectionData ) ) );
+        fieldData.coverageFile = QFileInfo( file ).dir().absoluteFilePath( fileName );
+      }
+      break;
+
+      // unknown sections of newer versions
+      default:
+        break;
+    }
+  }
+
+  unmap();
+
+  return ok;
+}
+
+bool FieldBinary::write( QIODevice& device, GeographicConvertionWrapper& tmw, const FieldData& fieldData ) {
+  const bool hasBoundary = fieldData.field && !fieldData.field->outer_boundary().is_empty();
+  const bool hasPoints = !fieldData.points.empty();
+
+  // relative to the field, so both can be moved together
+  QByteArray coverageFile;
+
+  if( !fieldData.coverageFile.isEmpty() ) {
+    const auto* file = qobject_cast<QFile*>( &device );
+    QString fileName = QDir::cleanPath( fieldData.coverageFile );
+
+    if( file != nullptr ) {
+      const QString relativeFileName = QFileInfo( *file ).dir().relativeFilePath( fileName );
+
+      if( !relativeFileName.startsWith( QLatin1String( "../" ) ) ) {
+        fileName = relativeFileName;
+      }
+    }
+
+    coverageFile = fileName.toUtf8();
+  }
+
+  const bool hasCoverage = !coverageFile.isEmpty();
+  const quint32 numSections = 1 + ( hasBoundary ? 1 : 0 ) + ( hasPoints ? 1 : 0 ) + ( hasCoverage ? 1 : 0 );
+
+  // the sizes of the sections
+  const quint64 sizeOfMetadata = 24;
+  quint64 sizeOfBoundary = 0;
+
+  if( hasBoundary ) {
+    quint64 numVertices = fieldData.field->outer_boundary().size();
+
+    for( auto hole = fieldData.field->holes_begin(), end = fieldData.field->holes_end(); hole != end; ++hole ) {
+      numVertices += hole->size();
+    }
+
+    sizeOfBoundary = 8 + align8( quint64( 1 + fieldData.field->number_of_holes() ) * 4 ) + numVertices * 16;
+  }
+
+  const quint64 sizeOfCoverage = hasCoverage ? align8( 8 + quint64( coverageFile.size() ) ) : 0;
+  const quint64 sizeOfPoints = hasPoints ? ( 8 + quint64( fieldData.points.size() ) * 24 ) : 0;
+
+  // header and section table
+  LittleEndianBuffer header;
+  {
+    double latitude = 0, longitude = 0, height = 0;
+    tmw.getOrigin( latitude, longitude, height );
+
+    header.buffer.append( magic, sizeof( magic ) );
+    header.appendU32( version );
+    header.appendU32( numSections );
+    header.appendF64( latitude );
+    header.appendF64( longitude );
+    header.appendF64( height );
+    header.appendU32( tmw.useTM ? 1 : 0 );
+    header.appendU32( 0 );
+
+    quint64 offset = quint64( headerSize ) + quint64( numSections ) * sectionEntrySize;
+
+    auto appendSection = [&header, &offset]( SectionType type, quint64 size ) {
+      header.appendU32( quint32( type ) );
+      header.appendU32( 0 );
+      header.appendU64( offset );
+      header.appendU64( size );
+      offset += size;
+    };
+
+    appendSection( SectionType::Metadata, sizeOfMetadata );
+
+    if( hasBoundary ) {
+      appendSection( SectionType::Boundary, sizeOfBoundary );
+    }
+
+    if( hasCoverage ) {
+      appendSection( SectionType::Coverage, sizeOfCoverage );
+    }
+
+    // the points last, as they are written in batches after the rest
+    if( hasPoints ) {
+      appendSection( SectionType::Points, sizeOfPoints );
+    }
+  }
+
+  // metadata, boundary and coverage are small, so they are written together with the header
+  header.appendF64( fieldData.alpha );
+  header.appendF64( fieldData.distanceBetweenConnectPoints );
+  header.appendF64( fieldData.maxDeviation );
+
+  if( hasBoundary ) {
+    header.appendU32( quint32( 1 + fieldData.field->number_of_holes() ) );
+    header.appendU32( 0 );
+    header.appendU32( quint32( fieldData.field->outer_boundary().size() ) );
+
+    for( auto hole = fieldData.field->holes_begin(), end = fieldData.field->holes_end(); hole != end; ++hole ) {
+      header.appendU32( quint32( hole->size() ) );
+    }
+
+    header.padTo8();
+
+    auto appendRing = [&header]( const Polygon_2 & ring ) {
+      for( const auto& vertex : ring.container() ) {
+        header.appendF64( vertex.x() );
+        header.appendF64( vertex.y() );
+      }
+    };
+
+    appendRing( fieldData.field->outer_boundary() );
+
+    for( auto hole = fieldData.field->holes_begin(), end = fieldData.field->holes_end(); hole != end; ++hole ) {
+      appendRing( *hole );
+    }
+  }
+
+  if( hasCoverage ) {
+    header.appendU32( quint32( coverageFile.size() ) );
+    header.appendU32( 0 );
+    header.buffer.append( coverageFile );
+    header.padTo8();
+  }
+
+  bool ok = device.write( header.buffer ) == header.buffer.size();
+
+  // the points in batches
+  if( hasPoints && ok ) {
+    LittleEndianBuffer batch;
+    batch.appendU64( fieldData.points.size() );
+
+    for( const auto& point : fieldData.points ) {
+      batch.appendF64( point.x() );
+      batch.appendF64( point.y() );
+      batch.appendF64( point.z() );
+
+      if( batch.buffer.size() >= ( 1 << 20 ) ) {
+        ok &= device.write( batch.buffer ) == batch.buffer.size();
+        batch.buffer.clear();
+      }
+    }
+
+    ok &= device.write( batch.buffer ) == batch.buffer.size();
+  }
+
+  return ok;
+}
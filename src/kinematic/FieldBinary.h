@@ -0,0 +1,61 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QIODevice>
+#include <QFile>
+
+#include "../kinematic/FieldData.h"
+
+class GeographicConvertionWrapper;
+
+// a compact binary container for fields. The coordinates are stored in the local system of the
+// GeographicConvertionWrapper together with its origin, so loading into the same origin is a copy.
+//
+// layout, all little-endian, sections aligned to 8 bytes:
+//   header:   char magic[8] "QOGFIELD", uint32 version, uint32 numSections,
+//             double originLatitude, originLongitude, originHeight, uint32 useTM, uint32 reserved
+//   sections: numSections x { uint32 type, uint32 reserved, uint64 offset, uint64 size }
+//   Metadata: double alpha, distanceBetweenConnectPoints, maxDeviation
+//   Boundary: uint32 numRings, uint32 reserved, uint32 numVertices[numRings] (padded to 8), double x, y...;
+//             the first ring is the outer boundary, the others are holes
+//   Points:   uint64 numPoints, double x, y, z...
+//   Coverage: uint32 size, uint32 reserved, char fileName[size] (UTF-8); the file of the CoverageMap, relative
+//             to the directory of the field file if it's in it or below. The tiles stay in their own file, as
+//             CoverageMap appends to it while working
+// Unknown sections are skipped, so newer versions can add their own
+class FieldBinary {
+  public:
+    enum class SectionType : uint32_t {
+      Metadata = 1,
+      Boundary = 2,
+      Points = 3,
+      Coverage = 4
+    };
+
+    static constexpr uint32_t version = 1;
+
+    // checks the magic at the start of the file; doesn't change the position
+    static bool isFieldBinary( QFile& file );
+
+    // the raw points are skipped, if withRawPoints is false
+    static bool read( QFile& file, GeographicConvertionWrapper& tmw, FieldData& fieldData, bool withRawPoints = true );
+
+    static bool write( QIODevice& device, GeographicConvertionWrapper& tmw, const FieldData& fieldData );
+};
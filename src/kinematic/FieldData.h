@@ -0,0 +1,44 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QString>
+
+#include <vector>
+#include <memory>
+
+#include "../kinematic/cgalKernel.h"
+
+// the content of a field file, in the local coordinates of the GeographicConvertionWrapper
+struct FieldData {
+  // the processed boundary; nullptr, if the file has none
+  std::shared_ptr<Polygon_with_holes_2> field;
+
+  // the raw points as recorded
+  std::vector<Point_3> points;
+  bool hasPoints = false;
+
+  // the file of the CoverageMap of the field; empty, if it has none
+  QString coverageFile;
+
+  // the settings the boundary was calculated with
+  double alpha = 0;
+  double distanceBetweenConnectPoints = 0;
+  double maxDeviation = 0;
+};
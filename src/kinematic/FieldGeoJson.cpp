@@ -0,0 +1,779 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "FieldGeoJson.h"
+
+#include <QByteArray>
+
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "GeographicConvertionWrapper.h"
+
+namespace {
+  // the positions of a "coordinates" member, flattened: every innermost array of numbers is a position,
+  // an array of positions starts a ring, an array of rings starts a polygon
+  struct Coordinates {
+    std::vector<GeographicConvertionWrapper::GeographicPosition> positions;
+    std::vector<std::size_t> ringStarts;
+    std::vector<std::size_t> polygonStarts;
+
+    std::size_t endOfRing( std::size_t ring ) const {
+      return ( ring + 1 ) < ringStarts.size() ? ringStarts[ring + 1] : positions.size();
+    }
+
+    std::size_t endOfPolygon( std::size_t polygon ) const {
+      return ( polygon + 1 ) < polygonStarts.size() ? polygonStarts[polygon + 1] : ringStarts.size();
+    }
+  };
+
+  // a pull parser for the subset of GeoJSON written by FieldGeoJson::write() and QJsonDocument;
+  // unknown members are skipped
+  class GeoJsonParser {
+    public:
+      GeoJsonParser( const char* begin, const char* end, bool withRawPoints )
+        : pos( begin ), end( end ), withRawPoints( withRawPoints ) {}
+
+      bool parseFeatureCollection( GeographicConvertionWrapper& tmw, FieldData& fieldData ) {
+        bool isFeatureCollection = false;
+
+        bool ok = parseObject( [&]( const QByteArray & key ) {
+          if( key == "type" ) {
+            QByteArray type;
+
+            if( !parseString( type ) ) {
+              return false;
+            }
+
+            isFeatureCollection = ( type == "FeatureCollection" );
+            return true;
+          }
+
+          if( key == "features" ) {
+            return parseArray( [&]() {
+              return parseFeature( tmw, fieldData );
+            } );
+          }
+
+          return skipValue();
+        } );
+
+        return ok && isFeatureCollection;
+      }
+
+    private:
+      bool parseFeature( GeographicConvertionWrapper& tmw, FieldData& fieldData ) {
+        bool isFeature = false;
+        QByteArray geometryType;
+        Coordinates coordinates;
+        double alpha = 0;
+        double distanceBetweenConnectPoints = 0;
+        double maxDeviation = 0;
+
+        bool ok = parseObject( [&]( const QByteArray & key ) {
+          if( key == "type" ) {
+            QByteArray type;
+
+            if( !parseString( type ) ) {
+              return false;
+            }
+
+            isFeature = ( type == "Feature" );
+            return true;
+          }
+
+          if( key == "geometry" ) {
+            return parseGeometry( geometryType, coordinates );
+          }
+
+          if( key == "properties" ) {
+            return parseObject( [&]( const QByteArray & property ) {
+              if( property == "alpha" ) {
+                return parseNumber( alpha );
+              }
+
+              if( property == "connect-points-distance" ) {
+                return parseNumber( distanceBetweenConnectPoints );
+              }
+
+              if( property == "simplification-max-deviation" ) {
+                return parseNumber( maxDeviation );
+              }
+
+              return skipValue();
+            } );
+          }
+
+          return skipValue();
+        } );
+
+        if( !ok ) {
+          return false;
+        }
+
+        if( isFeature ) {
+          // processed field: the first polygon of it with its holes
+          if( ( geometryType == "Polygon" || geometryType == "MultiPolygon" ) && !coordinates.ringStarts.empty() ) {
+            if( coordinates.polygonStarts.empty() ) {
+              coordinates.polygonStarts.push_back( 0 );
+            }
+
+            auto field = std::make_shared<Polygon_with_holes_2>();
+
+            const std::size_t numRings = coordinates.endOfPolygon( 0 );
+            const std::size_t beginOfPolygon = coordinates.ringStarts[0];
+            const std::size_t endOfPolygon = numRings > 0 ? coordinates.endOfRing( numRings - 1 ) : beginOfPolygon;
+            std::vector<GeographicConvertionWrapper::LocalPosition> localPositions( endOfPolygon - beginOfPolygon );
+            tmw.Forward( coordinates.positions.data() + beginOfPolygon, localPositions.data(), localPositions.size(), false );
+
+            for( std::size_t ring = 0; ring < numRings; ++ring ) {
+              Polygon_2 poly;
+
+              for( std::size_t i = coordinates.ringStarts[ring], endOfRing = coordinates.endOfRing( ring ); i < endOfRing; ++i ) {
+                const auto& localPosition = localPositions[i - beginOfPolygon];
+                poly.push_back( Point_2( localPosition.x, localPosition.y ) );
+              }
+
+              // GeoJSON repeats the first position at the end
+              if( poly.size() > 1 && poly.vertex( 0 ) == poly.vertex( int( poly.size() - 1 ) ) ) {
+                poly.container().pop_back();
+              }
+
+              if( ring == 0 ) {
+                field->outer_boundary() = std::move( poly );
+              } else if( poly.size() >= 3 ) {
+                field->add_hole( std::move( poly ) );
+              }
+            }
+
+            fieldData.field = field;
+            fieldData.alpha = alpha;
+            fieldData.distanceBetweenConnectPoints = distanceBetweenConnectPoints;
+            fieldData.maxDeviation = maxDeviation;
+          }
+
+          // raw points
+          if( geometryType == "MultiPoint" && !coordinates.positions.empty() && withRawPoints ) {
+            std::vector<GeographicConvertionWrapper::LocalPosition> localPositions( coordinates.positions.size() );
+            tmw.Forward( coordinates.positions.data(), localPositions.data(), localPositions.size(), true, true );
+
+            fieldData.points.clear();
+            fieldData.points.reserve( localPositions.size() );
+
+            for( const auto& localPosition : localPositions ) {
+              fieldData.points.emplace_back( localPosition.x, localPosition.y, localPosition.z );
+            }
+
+            fieldData.hasPoints = true;
+          }
+        }
+
+        return true;
+      }
+
+      bool parseGeometry( QByteArray& geometryType, Coordinates& coordinates ) {
+        // QJsonDocument sorts the members, so "coordinates" comes before "type"
+        return parseObject( [&]( const QByteArray & key ) {
+          if( key == "type" ) {
+            return parseString( geometryType );
+          }
+
+          if( key == "coordinates" ) {
+            return parseCoordinates( coordinates ) >= 0;
+          }
+
+          return skipValue();
+        } );
+      }
+
+      // returns the nesting level of the array: 0 for a position, 1 for a ring, 2 for a polygon...; -1 on error
+      int parseCoordinates( Coordinates& coordinates ) {
+        skipWhitespace();
+
+        if( pos == end || *pos != '[' ) {
+          return -1;
+        }
+
+        const std::size_t positionsBegin = coordinates.positions.size();
+        const std::size_t ringsBegin = coordinates.ringStarts.size();
+
+        // peek, if the array holds numbers
+        const char* content = pos + 1;
+
+        while( content != end && isWhitespace( *content ) ) {
+          ++content;
+        }
+
+        if( content != end && ( *content == '-' || ( *content >= '0' && *content <= '9' ) ) ) {
+          std::array<double, 3> position = { 0, 0, 0 };
+          std::size_t i = 0;
+
+          bool ok = parseArray( [&]() {
+            double value = 0;
+
+            if( !parseNumber( value ) ) {
+              return false;
+            }
+
+            if( i < position.size() ) {
+              position[i] = value;
+            }
+
+            ++i;
+            return true;
+          } );
+
+          if( !ok || i < 2 ) {
+            return -1;
+          }
+
+          // GeoJSON has the longitude first
+          coordinates.positions.push_back( { position[1], position[0], position[2] } );
+          return 0;
+        }
+
+        int level = -1;
+
+        bool ok = parseArray( [&]() {
+          int levelOfElement = parseCoordinates( coordinates );
+
+          if( levelOfElement < 0 ) {
+            return false;
+          }
+
+          level = std::max( level, levelOfElement + 1 );
+          return true;
+        } );
+
+        if( !ok ) {
+          return -1;
+        }
+
+        // an empty array is taken as an empty ring
+        if( level < 0 ) {
+          level = 1;
+        }
+
+        if( level == 1 ) {
+          coordinates.ringStarts.insert( coordinates.ringStarts.begin() + long( ringsBegin ), positionsBegin );
+        }
+
+        if( level == 2 ) {
+          coordinates.polygonStarts.push_back( ringsBegin );
+        }
+
+        return level;
+      }
+
+      template<typename Function>
+      bool parseObject( Function member ) {
+        skipWhitespace();
+
+        if( pos == end || *pos != '{' ) {
+          return false;
+        }
+
+        ++pos;
+        skipWhitespace();
+
+        if( pos != end && *pos == '}' ) {
+          ++pos;
+          return true;
+        }
+
+        QByteArray key;
+
+        while( pos != end ) {
+          if( !parseString( key ) ) {
+            return false;
+          }
+
+          skipWhitespace();
+
+          if( pos == end || *pos != ':' ) {
+            return false;
+          }
+
+          ++pos;
+
+          if( !member( key ) ) {
+            return false;
+          }
+
+          skipWhitespace();
+
+          if( pos != end && *pos == ',' ) {
+            ++pos;
+            skipWhitespace();
+            continue;
+          }
+
+          if( pos != end && *pos == '}' ) {
+            ++pos;
+            return true;
+          }
+
+          return false;
+        }
+
+        return false;
+      }
+
+      template<typename Function>
+      bool parseArray( Function element ) {
+        skipWhitespace();
+
+        if( pos == end || *pos != '[' ) {
+          return false;
+        }
+
+        ++pos;
+        skipWhitespace();
+
+        if( pos != end && *pos == ']' ) {
+          ++pos;
+          return true;
+        }
+
+        while( pos != end ) {
+          if( !element() ) {
+            return false;
+          }
+
+          skipWhitespace();
+
+          if( pos != end && *pos == ',' ) {
+            ++pos;
+            continue;
+          }
+
+          if( pos != end && *pos == ']' ) {
+            ++pos;
+            return true;
+          }
+
+          return false;
+        }
+
+        return false;
+      }
+
+      // the escapes are only resolved as far as needed for comparing the keys and types
+      bool parseString( QByteArray& string ) {
+        skipWhitespace();
+
+        if( pos == end || *pos != '"' ) {
+          return false;
+        }
+
+        ++pos;
+        string.clear();
+
+        while( pos != end && *pos != '"' ) {
+          if( *pos == '\\' ) {
+            if( ++pos == end ) {
+              return false;
+            }
+          }
+
+          string.append( *pos++ );
+        }
+
+        if( pos == end ) {
+          return false;
+        }
+
+        ++pos;
+        return true;
+      }
+
+      // exact for up to 15 significant digits and exponents within [-22, 22] (which covers all the written
+      // coordinates), otherwise QByteArray::toDouble() takes over. Independent of the locale, unlike strtod()
+      bool parseNumber( double& value ) {
+        skipWhitespace();
+
+        const char* begin = pos;
+        bool negative = false;
+
+        if( pos != end && *pos == '-' ) {
+          negative = true;
+          ++pos;
+        }
+
+        uint64_t mantissa = 0;
+        int digits = 0;
+        int exponent = 0;
+
+        while( pos != end && *pos >= '0' && *pos <= '9' ) {
+          if( digits < 19 ) {
+            mantissa = mantissa * 10 + uint64_t( *pos - '0' );
+          } else {
+            ++exponent;
+          }
+
+          if( mantissa != 0 ) {
+            ++digits;
+          }
+
+          ++pos;
+        }
+
+        if( pos != end && *pos == '.' ) {
+          ++pos;
+
+          while( pos != end && *pos >= '0' && *pos <= '9' ) {
+            if( digits < 19 ) {
+              mantissa = mantissa * 10 + uint64_t( *pos - '0' );
+              --exponent;
+            }
+
+            if( mantissa != 0 ) {
+              ++digits;
+            }
+
+            ++pos;
+          }
+        }
+
+        if( pos != end && ( *pos == 'e' || *pos == 'E' ) ) {
+          ++pos;
+          bool negativeExponent = false;
+
+          if( pos != end && ( *pos == '+' || *pos == '-' ) ) {
+            negativeExponent = ( *pos == '-' );
+            ++pos;
+          }
+
+          int explicitExponent = 0;
+
+          while( pos != end && *pos >= '0' && *pos <= '9' ) {
+            explicitExponent = std::min( explicitExponent * 10 + ( *pos - '0' ), 100000 );
+            ++pos;
+          }
+
+          exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        }
+
+        if( pos == begin || ( negative && pos == begin + 1 ) ) {
+          return false;
+        }
+
+        static const double powersOf10[] = {
+          1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+          1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        if( digits <= 15 && exponent >= -22 && exponent <= 22 ) {
+          value = double( mantissa );
+          value = ( exponent < 0 ) ? ( value / powersOf10[-exponent] ) : ( value * powersOf10[exponent] );
+        } else {
+          bool ok = false;
+          value = QByteArray( begin, int( pos - begin ) ).toDouble( &ok );
+
+          if( !ok ) {
+            return false;
+          }
+
+          return true;
+        }
+
+        if( negative ) {
+          value = -value;
+        }
+
+        return true;
+      }
+
+      bool skipValue() {
+        skipWhitespace();
+
+        if( pos == end ) {
+          return false;
+        }
+
+        switch( *pos ) {
+          case '{':
+            return parseObject( [this]( const QByteArray& ) {
+              return skipValue();
+            } );
+
+          case '[':
+            return parseArray( [this]() {
+              return skipValue();
+            } );
+
+          case '"': {
+            QByteArray string;
+            return parseString( string );
+          }
+
+          case 't':
+          case 'f':
+          case 'n':
+            while( pos != end && *pos >= 'a' && *pos <= 'z' ) {
+              ++pos;
+            }
+
+            return true;
+
+          default: {
+            double value;
+            return parseNumber( value );
+          }
+        }
+      }
+
+      static bool isWhitespace( char c ) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+      }
+
+      void skipWhitespace() {
+        while( pos != end && isWhitespace( *pos ) ) {
+          ++pos;
+        }
+      }
+
+    private:
+      const char* pos;
+      const char* end;
+      bool withRawPoints;
+  };
+
+  // buffers the output and flushes it to the device every megabyte
+  class GeoJsonWriter {
+    public:
+      explicit GeoJsonWriter( QIODevice& device )
+        : device( device ) {
+        buffer.reserve( bufferSize + 1024 );
+      }
+
+      void append( const char* string ) {
+        buffer.append( string );
+      }
+
+      // fixed point with the trailing zeros removed; the common case without a call to the locale-dependent printf()
+      void appendFixed( double value, int decimals ) {
+        static const double scales[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+        static const int64_t scalesInt[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+        if( !std::isfinite( value ) ) {
+          buffer.append( '0' );
+          return;
+        }
+
+        if( std::abs( value ) * scales[decimals] > 9e18 ) {
+          buffer.append( QByteArray::number( value, 'g', 17 ) );
+          return;
+        }
+
+        int64_t scaled = std::llround( value * scales[decimals] );
+
+        if( scaled < 0 ) {
+          buffer.append( '-' );
+          scaled = -scaled;
+        }
+
+        int64_t integer = scaled / scalesInt[decimals];
+        int64_t fraction = scaled % scalesInt[decimals];
+
+        char digits[24];
+        int numDigits = 0;
+
+        do {
+          digits[numDigits++] = char( '0' + integer % 10 );
+          integer /= 10;
+        } while( integer != 0 );
+
+        while( numDigits != 0 ) {
+          buffer.append( digits[--numDigits] );
+        }
+
+        if( fraction != 0 ) {
+          for( int i = decimals - 1; i >= 0; --i ) {
+            digits[i] = char( '0' + fraction % 10 );
+            fraction /= 10;
+          }
+
+          numDigits = decimals;
+
+          while( digits[numDigits - 1] == '0' ) {
+            --numDigits;
+          }
+
+          buffer.append( '.' );
+          buffer.append( digits, numDigits );
+        }
+      }
+
+      bool flushIfFull() {
+        return buffer.size() < bufferSize || flush();
+      }
+
+      bool flush() {
+        bool ok = device.write( buffer ) == buffer.size();
+        buffer.clear();
+        return ok;
+      }
+
+    private:
+      static constexpr int bufferSize = 1 << 20;
+
+      QIODevice& device;
+      QByteArray buffer;
+  };
+}
+
+bool FieldGeoJson::read( QFile& file, GeographicConvertionWrapper& tmw, FieldData& fieldData, bool withRawPoints ) {
+  // map the file if possible, so the content isn't copied
+  QByteArray content;
+  const char* begin = nullptr;
+  const qint64 size = file.size();
+  uchar* mapped = ( size > 0 ) ? file.map( 0, size ) : nullptr;
+
+  if( mapped != nullptr ) {
+    begin = reinterpret_cast<const char*>( mapped );
+  } else {
+    content = file.readAll();
+    begin = content.constData();
+  }
+
+  const char* end = begin + ( mapped != nullptr ? size : content.size() );
+
+  GeoJsonParser parser( begin, end, withRawPoints );
+  bool ok = parser.parseFeatureCollection( tmw, fieldData );
+
+  if( mapped != nullptr ) {
+    file.unmap( mapped );
+  }
+
+  return ok;
+}
+
+bool FieldGeoJson::write( QIODevice& device, GeographicConvertionWrapper& tmw, const FieldData& fieldData ) {
+  GeoJsonWriter writer( device );
+  bool ok = true;
+
+  auto appendProperties = [&writer, &fieldData]( const char* name ) {
+    writer.append( "\"properties\":{\"alpha\":" );
+    writer.appendFixed( fieldData.alpha, 6 );
+    writer.append( ",\"connect-points-distance\":" );
+    writer.appendFixed( fieldData.distanceBetweenConnectPoints, 6 );
+    writer.append( ",\"name\":\"" );
+    writer.append( name );
+    writer.append( "\",\"simplification-max-deviation\":" );
+    writer.appendFixed( fieldData.maxDeviation, 6 );
+    writer.append( "}," );
+  };
+
+  writer.append( "{\"features\":[" );
+
+  // processed field as Polygon, the first ring is the outer boundary, followed by the holes
+  if( fieldData.field ) {
+    writer.append( "\n{\"geometry\":{\"coordinates\":[" );
+
+    std::vector<GeographicConvertionWrapper::LocalPosition> localPositions;
+    std::vector<GeographicConvertionWrapper::GeographicPosition> positions;
+
+    auto appendRing = [&]( const Polygon_2 & ring ) {
+      writer.append( "[" );
+
+      localPositions.clear();
+
+      for( const auto& vertex : ring.container() ) {
+        localPositions.push_back( { vertex.x(), vertex.y(), 0 } );
+      }
+
+      positions.resize( localPositions.size() );
+      tmw.Reverse( localPositions.data(), positions.data(), localPositions.size(), false );
+
+      // close the ring with the first point
+      for( std::size_t i = 0, size = positions.size(); i <= size; ++i ) {
+        const auto& position = positions[i % size];
+
+        writer.append( i == 0 ? "[" : ",[" );
+        writer.appendFixed( position.longitude, 9 );
+        writer.append( "," );
+        writer.appendFixed( position.latitude, 9 );
+        writer.append( "]" );
+
+        ok &= writer.flushIfFull();
+      }
+
+      writer.append( "]" );
+    };
+
+    if( !fieldData.field->outer_boundary().is_empty() ) {
+      appendRing( fieldData.field->outer_boundary() );
+
+      for( auto hole = fieldData.field->holes_begin(), end = fieldData.field->holes_end(); hole != end; ++hole ) {
+        if( !hole->is_empty() ) {
+          writer.append( "," );
+          appendRing( *hole );
+        }
+      }
+    }
+
+    writer.append( "],\"type\":\"Polygon\"}," );
+    appendProperties( "processed polygon" );
+    writer.append( "\"type\":\"Feature\"}" );
+  }
+
+  // recorded points as MultiPoint
+  if( !fieldData.points.empty() ) {
+    writer.append( fieldData.field ? ",\n{\"geometry\":{\"coordinates\":[" : "\n{\"geometry\":{\"coordinates\":[" );
+
+    // convert a batch, then format it
+    constexpr std::size_t batchSize = 65536;
+    std::vector<GeographicConvertionWrapper::LocalPosition> localPositions( batchSize );
+    std::vector<GeographicConvertionWrapper::GeographicPosition> batch( batchSize );
+
+    for( std::size_t offset = 0, size = fieldData.points.size(); offset < size; offset += batchSize ) {
+      const std::size_t numPoints = std::min( batchSize, size - offset );
+
+      for( std::size_t i = 0; i < numPoints; ++i ) {
+        const auto& point = fieldData.points[offset + i];
+        localPositions[i] = { point.x(), point.y(), point.z() };
+      }
+
+      tmw.Reverse( localPositions.data(), batch.data(), numPoints, true, true );
+
+      for( std::size_t i = 0; i < numPoints; ++i ) {
+        writer.append( ( offset + i ) == 0 ? "[" : ",\n[" );
+        writer.appendFixed( batch[i].longitude, 9 );
+        writer.append( "," );
+        writer.appendFixed( batch[i].latitude, 9 );
+        writer.append( "," );
+        writer.appendFixed( batch[i].height, 4 );
+        writer.append( "]" );
+      }
+
+      ok &= writer.flushIfFull();
+    }
+
+    writer.append( "],\"type\":\"MultiPoint\"}," );
+    appendProperties( "raw points" );
+    writer.append( "\"type\":\"Feature\"}" );
+  }
+
+  writer.append( "\n],\"type\":\"FeatureCollection\"}\n" );
+  ok &= writer.flush();
+
+  return ok;
+}
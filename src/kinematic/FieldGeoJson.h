@@ -0,0 +1,39 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QIODevice>
+#include <QFile>
+
+#include "../kinematic/FieldData.h"
+
+class GeographicConvertionWrapper;
+
+// reads and writes fields as GeoJSON without building a QJsonDocument: the writer formats the coordinates
+// directly into a buffer, which is flushed to the device every megabyte, and the reader is a pull parser
+// over the (memory mapped, if possible) file. The coordinates are converted a feature at a time.
+// Longitude and latitude are written with 9 decimals (about 0.1mm), the height with 4
+class FieldGeoJson {
+  public:
+    // returns false, if the file isn't a FeatureCollection or not valid JSON. The raw points are
+    // skipped, if withRawPoints is false
+    static bool read( QFile& file, GeographicConvertionWrapper& tmw, FieldData& fieldData, bool withRawPoints = true );
+
+    static bool write( QIODevice& device, GeographicConvertionWrapper& tmw, const FieldData& fieldData );
+};
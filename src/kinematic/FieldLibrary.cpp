@@ -0,0 +1,392 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "FieldLibrary.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDebug>
+
+#include <algorithm>
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include "GeographicConvertionWrapper.h"
+#include "FieldData.h"
+#include "FieldGeoJson.h"
+#include "FieldBinary.h"
+
+namespace bg = boost::geometry;
+namespace bgi = boost::geometry::index;
+
+namespace {
+  // longitude, latitude
+  using IndexPoint = bg::model::point<double, 2, bg::cs::cartesian>;
+  using IndexBox = bg::model::box<IndexPoint>;
+  using IndexValue = std::pair<IndexBox, std::size_t>;
+
+  const QString indexFileName = QStringLiteral( ".fieldlibrary.json" );
+
+  // only the boundary, the raw points are skipped
+  bool readBoundary( const QString& fileName, GeographicConvertionWrapper& tmw, FieldData& fieldData ) {
+    QFile file( fileName );
+
+    if( !file.open( QIODevice::ReadOnly ) ) {
+      return false;
+    }
+
+    return FieldBinary::isFieldBinary( file ) ?
+           FieldBinary::read( file, tmw, fieldData, false ) :
+           FieldGeoJson::read( file, tmw, fieldData, false );
+  }
+
+  // a ring as [longitude, latitude, longitude, latitude, ...]
+  QJsonArray ringToJson( const Polygon_2& ring ) {
+    QJsonArray array;
+
+    for( const auto& vertex : ring.container() ) {
+      array.push_back( vertex.x() );
+      array.push_back( vertex.y() );
+    }
+
+    return array;
+  }
+
+  Polygon_2 ringFromJson( const QJsonArray& array ) {
+    Polygon_2 ring;
+
+    for( int i = 0; ( i + 1 ) < array.size(); i += 2 ) {
+      ring.push_back( Point_2( array.at( i ).toDouble(), array.at( i + 1 ).toDouble() ) );
+    }
+
+    return ring;
+  }
+
+  Polygon_2 ringToWGS84( const Polygon_2& ring, GeographicConvertionWrapper& tmw ) {
+    Polygon_2 ringInWGS84;
+
+    for( const auto& vertex : ring.container() ) {
+      double latitude, longitude, height;
+      tmw.Reverse( vertex.x(), vertex.y(), 0, latitude, longitude, height );
+      ringInWGS84.push_back( Point_2( longitude, latitude ) );
+    }
+
+    return ringInWGS84;
+  }
+}
+
+struct FieldLibrary::Index {
+  struct Entry {
+    // relative to the directory of the library
+    QString fileName;
+    qint64 modified = 0;
+    qint64 size = 0;
+
+    // files without a boundary are kept too, so they aren't read again on the next scan
+    bool hasBoundary = false;
+    double minLatitude = 0;
+    double minLongitude = 0;
+    double maxLatitude = 0;
+    double maxLongitude = 0;
+
+    // in WGS84 (x: longitude, y: latitude), so it doesn't depend on the origin of the local coordinates
+    Polygon_with_holes_2 boundary;
+
+    void setBoundary( const Polygon_with_holes_2& field, GeographicConvertionWrapper& tmw ) {
+      std::vector<Polygon_2> holes;
+
+      for( auto hole = field.holes_begin(), end = field.holes_end(); hole != end; ++hole ) {
+        holes.push_back( ringToWGS84( *hole, tmw ) );
+      }
+
+      boundary = Polygon_with_holes_2( ringToWGS84( field.outer_boundary(), tmw ), holes.begin(), holes.end() );
+
+      const auto bbox = boundary.outer_boundary().bbox();
+      hasBoundary = true;
+      minLatitude = bbox.ymin();
+      minLongitude = bbox.xmin();
+      maxLatitude = bbox.ymax();
+      maxLongitude = bbox.xmax();
+    }
+  };
+
+  void buildRtree();
+  void writeIndexFile() const;
+
+  QString directory;
+  std::vector<Entry> entries;
+  bgi::rtree<IndexValue, bgi::quadratic<16>> rtree;
+};
+
+void FieldLibrary::Index::buildRtree() {
+  std::vector<IndexValue> values;
+
+  for( std::size_t i = 0; i < entries.size(); ++i ) {
+    const auto& entry = entries[i];
+
+    if( entry.hasBoundary ) {
+      values.emplace_back( IndexBox( IndexPoint( entry.minLongitude, entry.minLatitude ),
+                                     IndexPoint( entry.maxLongitude, entry.maxLatitude ) ), i );
+    }
+  }
+
+  // bulk loading packs the tree
+  rtree = decltype( rtree )( values.begin(), values.end() );
+}
+
+void FieldLibrary::Index::writeIndexFile() const {
+  QJsonArray entriesArray;
+
+  for( const auto& entry : entries ) {
+    QJsonObject entryObject;
+    entryObject[QStringLiteral( "file" )] = entry.fileName;
+    entryObject[QStringLiteral( "modified" )] = double( entry.modified );
+    entryObject[QStringLiteral( "size" )] = double( entry.size );
+    entryObject[QStringLiteral( "boundary" )] = entry.hasBoundary;
+    entryObject[QStringLiteral( "min-latitude" )] = entry.minLatitude;
+    entryObject[QStringLiteral( "min-longitude" )] = entry.minLongitude;
+    entryObject[QStringLiteral( "max-latitude" )] = entry.maxLatitude;
+    entryObject[QStringLiteral( "max-longitude" )] = entry.maxLongitude;
+
+    if( entry.hasBoundary ) {
+      QJsonArray holesArray;
+
+      for( auto hole = entry.boundary.holes_begin(), end = entry.boundary.holes_end(); hole != end; ++hole ) {
+        holesArray.push_back( ringToJson( *hole ) );
+      }
+
+      entryObject[QStringLiteral( "outer" )] = ringToJson( entry.boundary.outer_boundary() );
+      entryObject[QStringLiteral( "holes" )] = holesArray;
+    }
+
+    entriesArray.push_back( entryObject );
+  }
+
+  QJsonObject jsonObject;
+  jsonObject[QStringLiteral( "fields" )] = entriesArray;
+
+  QFile indexFile( QDir( directory ).filePath( indexFileName ) );
+
+  if( indexFile.open( QIODevice::WriteOnly ) ) {
+    indexFile.write( QJsonDocument( jsonObject ).toJson( QJsonDocument::Compact ) );
+  } else {
+    qWarning() << "FieldLibrary::Index::writeIndexFile: couldn't write the index file in" << directory;
+  }
+}
+
+FieldLibrary::FieldLibrary()
+  : index( std::make_shared<Index>() ) {}
+
+FieldLibrary::~FieldLibrary() = default;
+
+std::size_t FieldLibrary::numFields() const {
+  return index->rtree.size();
+}
+
+std::shared_ptr<FieldLibrary::Index> FieldLibrary::scan( const QString& directory ) {
+  auto index = std::make_shared<Index>();
+  index->directory = directory;
+
+  if( directory.isEmpty() ) {
+    return index;
+  }
+
+  const QDir dir( directory );
+
+  // the boxes of the last scan
+  QHash<QString, Index::Entry> entriesOfIndexFile;
+  {
+    QFile indexFile( dir.filePath( indexFileName ) );
+
+    if( indexFile.open( QIODevice::ReadOnly ) ) {
+      const QJsonArray entriesArray = QJsonDocument::fromJson( indexFile.readAll() ).object()[QStringLiteral( "fields" )].toArray();
+
+      for( const auto& entryValue : entriesArray ) {
+        const QJsonObject entryObject = entryValue.toObject();
+        Index::Entry entry;
+        entry.fileName = entryObject[QStringLiteral( "file" )].toString();
+        entry.modified = qint64( entryObject[QStringLiteral( "modified" )].toDouble() );
+        entry.size = qint64( entryObject[QStringLiteral( "size" )].toDouble() );
+        entry.hasBoundary = entryObject[QStringLiteral( "boundary" )].toBool();
+        entry.minLatitude = entryObject[QStringLiteral( "min-latitude" )].toDouble();
+        entry.minLongitude = entryObject[QStringLiteral( "min-longitude" )].toDouble();
+        entry.maxLatitude = entryObject[QStringLiteral( "max-latitude" )].toDouble();
+        entry.maxLongitude = entryObject[QStringLiteral( "max-longitude" )].toDouble();
+
+        if( entry.hasBoundary ) {
+          const QJsonArray holesArray = entryObject[QStringLiteral( "holes" )].toArray();
+          std::vector<Polygon_2> holes;
+
+          for( const auto& holeValue : holesArray ) {
+            holes.push_back( ringFromJson( holeValue.toArray() ) );
+          }
+
+          entry.boundary = Polygon_with_holes_2( ringFromJson( entryObject[QStringLiteral( "outer" )].toArray() ),
+                                                 holes.begin(), holes.end() );
+
+          // index files without the boundaries are from an older version, read the file again
+          if( entry.boundary.outer_boundary().size() < 3 ) {
+            continue;
+          }
+        }
+
+        entriesOfIndexFile.insert( entry.fileName, entry );
+      }
+    }
+  }
+
+  int numFilesRead = 0;
+
+  QDirIterator it( directory,
+                   QStringList( { QStringLiteral( "*.geojson" ), QStringLiteral( "*.qogfield" ) } ),
+                   QDir::Files, QDirIterator::Subdirectories );
+
+  while( it.hasNext() ) {
+    const QString fileName = it.next();
+    const QFileInfo fileInfo = it.fileInfo();
+
+    Index::Entry entry;
+    entry.fileName = dir.relativeFilePath( fileName );
+    entry.modified = fileInfo.lastModified().toMSecsSinceEpoch();
+    entry.size = fileInfo.size();
+
+    auto entryOfIndexFile = entriesOfIndexFile.constFind( entry.fileName );
+
+    if( entryOfIndexFile != entriesOfIndexFile.cend() &&
+        entryOfIndexFile->modified == entry.modified && entryOfIndexFile->size == entry.size ) {
+      index->entries.push_back( *entryOfIndexFile );
+      continue;
+    }
+
+    // new or changed: read the boundary with its own origin and take the box of it in WGS84
+    GeographicConvertionWrapper tmwOfFile;
+    FieldData fieldData;
+
+    if( readBoundary( fileName, tmwOfFile, fieldData ) && fieldData.field && fieldData.field->outer_boundary().size() >= 3 ) {
+      entry.setBoundary( *fieldData.field, tmwOfFile );
+    }
+
+    index->entries.push_back( entry );
+    ++numFilesRead;
+  }
+
+  // write the index file again, if something changed
+  if( numFilesRead != 0 || int( index->entries.size() ) != entriesOfIndexFile.size() ) {
+    index->writeIndexFile();
+  }
+
+  index->buildRtree();
+
+  return index;
+}
+
+void FieldLibrary::setIndex( std::shared_ptr<Index> index ) {
+  libraryDirectory = index->directory;
+  this->index = std::move( index );
+}
+
+void FieldLibrary::clear() {
+  libraryDirectory.clear();
+  index = std::make_shared<Index>();
+}
+
+bool FieldLibrary::addField( const QString& fileName, const std::shared_ptr<Polygon_with_holes_2>& field, GeographicConvertionWrapper& tmw ) {
+  if( libraryDirectory.isEmpty() ) {
+    return false;
+  }
+
+  const QFileInfo fileInfo( fileName );
+  const QString relativeFileName = QDir( libraryDirectory ).relativeFilePath( fileInfo.absoluteFilePath() );
+
+  if( relativeFileName.startsWith( QLatin1String( "../" ) ) || QDir::isAbsolutePath( relativeFileName ) ||
+      !( fileInfo.suffix().compare( QLatin1String( "geojson" ), Qt::CaseInsensitive ) == 0 ||
+         fileInfo.suffix().compare( QLatin1String( "qogfield" ), Qt::CaseInsensitive ) == 0 ) ) {
+    return false;
+  }
+
+  Index::Entry entry;
+  entry.fileName = relativeFileName;
+  entry.modified = fileInfo.lastModified().toMSecsSinceEpoch();
+  entry.size = fileInfo.size();
+
+  if( field && field->outer_boundary().size() >= 3 && tmw.isOriginSet() ) {
+    entry.setBoundary( *field, tmw );
+  }
+
+  auto existingEntry = std::find_if( index->entries.begin(), index->entries.end(), [&relativeFileName]( const Index::Entry & entry ) {
+    return entry.fileName == relativeFileName;
+  } );
+
+  if( existingEntry != index->entries.end() ) {
+    *existingEntry = std::move( entry );
+  } else {
+    index->entries.push_back( std::move( entry ) );
+  }
+
+  index->writeIndexFile();
+  index->buildRtree();
+
+  return true;
+}
+
+QString FieldLibrary::fieldAt( const Point_2& position, GeographicConvertionWrapper& tmw ) const {
+  if( index->rtree.empty() || !tmw.isOriginSet() ) {
+    return QString();
+  }
+
+  double latitude, longitude, height;
+  tmw.Reverse( position.x(), position.y(), 0, latitude, longitude, height );
+  const Point_2 positionInWGS84( longitude, latitude );
+
+  std::vector<IndexValue> candidates;
+  index->rtree.query( bgi::intersects( IndexPoint( longitude, latitude ) ), std::back_inserter( candidates ) );
+
+  // if the boxes overlap, the smaller fields first
+  std::sort( candidates.begin(), candidates.end(), []( const IndexValue & lhs, const IndexValue & rhs ) {
+    return bg::area( lhs.first ) < bg::area( rhs.first );
+  } );
+
+  for( const auto& candidate : candidates ) {
+    const auto& boundary = index->entries[candidate.second].boundary;
+
+    if( boundary.outer_boundary().size() >= 3 &&
+        boundary.outer_boundary().bounded_side( positionInWGS84 ) != CGAL::ON_UNBOUNDED_SIDE ) {
+      bool inHole = false;
+
+      for( auto hole = boundary.holes_begin(), end = boundary.holes_end(); hole != end; ++hole ) {
+        if( hole->size() >= 3 && hole->bounded_side( positionInWGS84 ) == CGAL::ON_BOUNDED_SIDE ) {
+          inHole = true;
+          break;
+        }
+      }
+
+      if( !inHole ) {
+        return QDir( libraryDirectory ).filePath( index->entries[candidate.second].fileName );
+      }
+    }
+  }
+
+  return QString();
+}
@@ -0,0 +1,71 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QString>
+
+#include <vector>
+#include <memory>
+
+#include "../kinematic/cgalKernel.h"
+
+class GeographicConvertionWrapper;
+
+// indexes the saved fields (*.geojson and *.qogfield) in a directory by the bounding box of their
+// boundary in WGS84, so the field at a position can be found without opening all of them. The boxes
+// and the boundaries in WGS84 are kept in an index file in the directory, so only new or changed files
+// are read when scanning and fieldAt() never has to touch the disk.
+// Scanning can take long with many new files, so it is done by the static scan() on a thread of the pool;
+// the result is then set with setIndex()
+class FieldLibrary {
+  public:
+    // defined in the .cpp to keep the R-tree out of here
+    struct Index;
+
+  public:
+    FieldLibrary();
+    ~FieldLibrary();
+
+    // scans the directory and its subdirectories and updates the index file in it. Doesn't touch any
+    // FieldLibrary, so it can run on another thread
+    static std::shared_ptr<Index> scan( const QString& directory );
+
+    // replaces the library by the result of scan()
+    void setIndex( std::shared_ptr<Index> index );
+
+    // empties the library
+    void clear();
+
+    const QString& directory() const {
+      return libraryDirectory;
+    }
+
+    std::size_t numFields() const;
+
+    // adds or updates a field just saved into the directory of the library, without reading it again.
+    // Returns false, if the file isn't in the library
+    bool addField( const QString& fileName, const std::shared_ptr<Polygon_with_holes_2>& field, GeographicConvertionWrapper& tmw );
+
+    // returns the file name of the field containing the local position or an empty string
+    QString fieldAt( const Point_2& position, GeographicConvertionWrapper& tmw ) const;
+
+  private:
+    QString libraryDirectory;
+    std::shared_ptr<Index> index;
+};
@@ -32,7 +32,7 @@
 #include "../block/BlockBase.h"
 
 #include "../kinematic/cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 
 class FixedKinematic : public BlockBase {
     Q_OBJECT
@@ -50,45 +50,40 @@ class FixedKinematic : public BlockBase {
       m_offsetHookPoint = position;
     }
 
-    void setPose( const Point_3 position, const QQuaternion rotation, const PoseOption::Options options ) {
+    void setPose( const Pose& pose ) {
       QQuaternion orientation = QQuaternion();
 
-      if( !options.testFlag( PoseOption::CalculateWithoutOrientation ) ) {
-        orientation = rotation;
+      if( !pose.options.testFlag( PoseOption::CalculateWithoutOrientation ) ) {
+        orientation = pose.orientation;
       }
 
       QVector3D positionPivotPointCorrection;
 
-      if( !options.testFlag( PoseOption::CalculateFromPivotPoint ) ) {
+      if( !pose.options.testFlag( PoseOption::CalculateFromPivotPoint ) ) {
         positionPivotPointCorrection = orientation * -m_offsetHookPoint;
       }
 
-      Point_3 positionPivotPoint = Point_3( position.x() + double( positionPivotPointCorrection.x() ),
-                                            position.y() + double( positionPivotPointCorrection.y() ),
-                                            position.z() + double( positionPivotPointCorrection.z() ) );
+      Point_3 positionPivotPoint = Point_3( pose.position.x() + double( positionPivotPointCorrection.x() ),
+                                            pose.position.y() + double( positionPivotPointCorrection.y() ),
+                                            pose.position.z() + double( positionPivotPointCorrection.z() ) );
 
       QVector3D positionTowPointCorrection = orientation * m_offsetTowPoint;
       Point_3 positionTowPoint = Point_3( positionPivotPoint.x() + double( positionTowPointCorrection.x() ),
                                           positionPivotPoint.y() + double( positionTowPointCorrection.y() ),
                                           positionPivotPoint.z() + double( positionTowPointCorrection.z() ) );
 
-      if( options.testFlag( PoseOption::CalculateFromPivotPoint ) ) {
-        PoseOption::Options flags = options;
-        flags.setFlag( PoseOption::CalculateFromPivotPoint, false );
-        emit poseHookPointChanged( position, orientation, flags );
-        emit posePivotPointChanged( positionPivotPoint, orientation, flags );
-        emit poseTowPointChanged( positionTowPoint, orientation, flags );
-      } else {
-        emit poseHookPointChanged( position, orientation, options );
-        emit posePivotPointChanged( positionPivotPoint, orientation, options );
-        emit poseTowPointChanged( positionTowPoint, orientation, options );
-      }
+      PoseOption::Options flags = pose.options;
+      flags.setFlag( PoseOption::CalculateFromPivotPoint, false );
+
+      emit poseHookPointChanged( pose.derive( pose.position, orientation, flags ) );
+      emit posePivotPointChanged( pose.derive( positionPivotPoint, orientation, flags ) );
+      emit poseTowPointChanged( pose.derive( positionTowPoint, orientation, flags ) );
     }
 
   signals:
-    void poseHookPointChanged( const Point_3, const QQuaternion, const PoseOption::Options );
-    void posePivotPointChanged( const Point_3, const QQuaternion, const PoseOption::Options );
-    void poseTowPointChanged( const Point_3, const QQuaternion, const PoseOption::Options );
+    void poseHookPointChanged( const Pose& );
+    void posePivotPointChanged( const Pose& );
+    void poseTowPointChanged( const Pose& );
 
   private:
     // defined in the normal way: x+ is forwards, so m_offsetPivotPoint is a negative vector
@@ -113,11 +108,11 @@ class FixedKinematicFactory : public BlockFactory {
 
       b->addInputPort( QStringLiteral( "OffsetHookPoint" ), QLatin1String( SLOT( setOffsetHookPointPosition( QVector3D ) ) ) );
       b->addInputPort( QStringLiteral( "OffsetTowPoint" ), QLatin1String( SLOT( setOffsetTowPointPosition( QVector3D ) ) ) );
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
 
-      b->addOutputPort( QStringLiteral( "Pose Hook Point" ), QLatin1String( SIGNAL( poseHookPointChanged( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
-      b->addOutputPort( QStringLiteral( "Pose Pivot Point" ), QLatin1String( SIGNAL( posePivotPointChanged( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
-      b->addOutputPort( QStringLiteral( "Pose Tow Point" ), QLatin1String( SIGNAL( poseTowPointChanged( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addOutputPort( QStringLiteral( "Pose Hook Point" ), QLatin1String( SIGNAL( poseHookPointChanged( const Pose& ) ) ) );
+      b->addOutputPort( QStringLiteral( "Pose Pivot Point" ), QLatin1String( SIGNAL( posePivotPointChanged( const Pose& ) ) ) );
+      b->addOutputPort( QStringLiteral( "Pose Tow Point" ), QLatin1String( SIGNAL( poseTowPointChanged( const Pose& ) ) ) );
 
       return b;
     }
@@ -0,0 +1,321 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include <QtGlobal>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cmath>
+
+#include "GeographicConvertionWrapper.h"
+
+constexpr double GeographicConvertionWrapper::fastProjectionHalfSize;
+
+namespace {
+  // the monomials of the fast projection: 1, s, t, s², st, t², s³, s²t, st², t³
+  inline double evaluateCubic( const double* c, const double s, const double t ) {
+    return c[0] + s * ( c[1] + s * ( c[3] + s * c[6] ) ) + t * ( c[2] + t * ( c[5] + t * c[9] ) ) + s * t * ( c[4] + s * c[7] + t * c[8] );
+  }
+
+  inline double evaluateLinear( const double* c, const double s, const double t ) {
+    return c[0] + s * c[1] + t * c[2];
+  }
+
+  void monomials( const double s, const double t, double* m ) {
+    m[0] = 1;
+    m[1] = s;
+    m[2] = t;
+    m[3] = s * s;
+    m[4] = s * t;
+    m[5] = t * t;
+    m[6] = s * s * s;
+    m[7] = s * s * t;
+    m[8] = s * t * t;
+    m[9] = t * t * t;
+  }
+
+  // solves the normal equations ata * x = atb in place with gaussian elimination
+  template<int N>
+  void solve( double ( &ata )[N][N], double ( &atb )[N] ) {
+    for( int col = 0; col < N; ++col ) {
+      int pivot = col;
+
+      for( int row = col + 1; row < N; ++row ) {
+        if( std::abs( ata[row][col] ) > std::abs( ata[pivot][col] ) ) {
+          pivot = row;
+        }
+      }
+
+      std::swap( ata[col], ata[pivot] );
+      std::swap( atb[col], atb[pivot] );
+
+      for( int row = col + 1; row < N; ++row ) {
+        const double factor = ata[row][col] / ata[col][col];
+
+        for( int i = col; i < N; ++i ) {
+          ata[row][i] -= factor * ata[col][i];
+        }
+
+        atb[row] -= factor * atb[col];
+      }
+    }
+
+    for( int row = N - 1; row >= 0; --row ) {
+      for( int i = row + 1; i < N; ++i ) {
+        atb[row] -= ata[row][i] * atb[i];
+      }
+
+      atb[row] /= ata[row][row];
+    }
+  }
+
+  // least squares fit of the values at the sample points, with the first N monomials
+  template<int N>
+  void fit( const std::vector<std::array<double, 10>>& samples, const std::vector<double>& values, double* coefficients ) {
+    double ata[N][N] = {};
+    double atb[N] = {};
+
+    for( std::size_t i = 0; i < samples.size(); ++i ) {
+      for( int row = 0; row < N; ++row ) {
+        for( int col = 0; col < N; ++col ) {
+          ata[row][col] += samples[i][row] * samples[i][col];
+        }
+
+        atb[row] += samples[i][row] * values[i];
+      }
+    }
+
+    solve<N>( ata, atb );
+    std::copy( atb, atb + N, coefficients );
+  }
+
+  inline double normalizedLongitudeDifference( double difference ) {
+    if( difference > 180 ) {
+      difference -= 360;
+    } else if( difference < -180 ) {
+      difference += 360;
+    }
+
+    return difference;
+  }
+}
+
+bool GeographicConvertionWrapper::forwardFast( const double latitude, const double longitude, const double height, double& x, double& y, double& z ) const {
+  if( !fastProjection.valid || fastProjection.useTM != useTM || fastProjection.height0TM != height0TM ) {
+    return false;
+  }
+
+  const double s = ( latitude - fastProjection.latitude ) / fastProjection.halfSizeLatitude;
+  const double t = normalizedLongitudeDifference( longitude - fastProjection.longitude ) / fastProjection.halfSizeLongitude;
+
+  if( std::abs( s ) > 1 || std::abs( t ) > 1 ) {
+    return false;
+  }
+
+  const double deltaHeight = height - fastProjection.height;
+
+  x = evaluateCubic( fastProjection.x, s, t ) + deltaHeight * evaluateLinear( fastProjection.dx, s, t );
+  y = evaluateCubic( fastProjection.y, s, t ) + deltaHeight * evaluateLinear( fastProjection.dy, s, t );
+  z = evaluateCubic( fastProjection.z, s, t ) + deltaHeight * evaluateLinear( fastProjection.dz, s, t );
+
+  return true;
+}
+
+void GeographicConvertionWrapper::anchorFastProjection( const double latitude, const double longitude, const double height ) {
+  constexpr double metersPerDegree = 6378137 * M_PI / 180;
+  constexpr int numNodes = 8;
+  constexpr double heightStep = 100;
+
+  FastProjection& fp = fastProjection;
+  fp.valid = false;
+  fp.useTM = useTM;
+  fp.height0TM = height0TM;
+  fp.latitude = latitude;
+  fp.longitude = longitude;
+  fp.height = height;
+  fp.halfSizeLatitude = fastProjectionHalfSize / metersPerDegree;
+  fp.halfSizeLongitude = std::min( 1.0, fastProjectionHalfSize / ( metersPerDegree * std::max( 0.01, std::cos( latitude * M_PI / 180 ) ) ) );
+
+  // sample on chebyshev nodes, which keeps the maximal error of the fit low
+  std::vector<std::array<double, 10>> samples;
+  std::vector<double> valuesX, valuesY, valuesZ, derivativesX, derivativesY, derivativesZ;
+
+  for( int i = 0; i < numNodes; ++i ) {
+    for( int j = 0; j < numNodes; ++j ) {
+      const double s = std::cos( M_PI * ( 2 * i + 1 ) / ( 2 * numNodes ) );
+      const double t = std::cos( M_PI * ( 2 * j + 1 ) / ( 2 * numNodes ) );
+      const double latitudeOfNode = latitude + s * fp.halfSizeLatitude;
+      const double longitudeOfNode = longitude + t * fp.halfSizeLongitude;
+
+      double x, y, z, xAbove, yAbove, zAbove;
+      forwardExact( latitudeOfNode, longitudeOfNode, height, x, y, z );
+      forwardExact( latitudeOfNode, longitudeOfNode, height + heightStep, xAbove, yAbove, zAbove );
+
+      samples.emplace_back();
+      monomials( s, t, samples.back().data() );
+      valuesX.push_back( x );
+      valuesY.push_back( y );
+      valuesZ.push_back( z );
+      derivativesX.push_back( ( xAbove - x ) / heightStep );
+      derivativesY.push_back( ( yAbove - y ) / heightStep );
+      derivativesZ.push_back( ( zAbove - z ) / heightStep );
+    }
+  }
+
+  fit<10>( samples, valuesX, fp.x );
+  fit<10>( samples, valuesY, fp.y );
+  fit<10>( samples, valuesZ, fp.z );
+  fit<3>( samples, derivativesX, fp.dx );
+  fit<3>( samples, derivativesY, fp.dy );
+  fit<3>( samples, derivativesZ, fp.dz );
+
+  fp.valid = true;
+
+  // check the fit on a grid, at the height of the anchor and above it
+  constexpr int numChecks = 11;
+  fp.maxError = 0;
+
+  for( int i = 0; i < numChecks; ++i ) {
+    for( int j = 0; j < numChecks; ++j ) {
+      for( const double heightOfCheck : { height, height + heightStep } ) {
+        const double latitudeOfCheck = latitude + ( -1 + 2. * i / ( numChecks - 1 ) ) * fp.halfSizeLatitude;
+        const double longitudeOfCheck = longitude + ( -1 + 2. * j / ( numChecks - 1 ) ) * fp.halfSizeLongitude;
+
+        double x, y, z, xFast, yFast, zFast;
+        forwardExact( latitudeOfCheck, longitudeOfCheck, heightOfCheck, x, y, z );
+
+        if( forwardFast( latitudeOfCheck, longitudeOfCheck, heightOfCheck, xFast, yFast, zFast ) ) {
+          fp.maxError = std::max( fp.maxError, std::sqrt( ( x - xFast ) * ( x - xFast ) + ( y - yFast ) * ( y - yFast ) + ( z - zFast ) * ( z - zFast ) ) );
+        }
+      }
+    }
+  }
+}
+
+// runs function( begin, end ) over [0, count); in parallel for big batches
+template<typename Function>
+static void forEachRange( std::size_t count, bool parallel, Function function ) {
+  constexpr std::size_t minSizeOfRange = 16384;
+
+  if( !parallel || count < 2 * minSizeOfRange || QThread::idealThreadCount() < 2 ) {
+    function( std::size_t( 0 ), count );
+    return;
+  }
+
+  const std::size_t numRanges = std::size_t( QThread::idealThreadCount() ) * 2;
+  const std::size_t sizeOfRange = std::max( minSizeOfRange, ( count + numRanges - 1 ) / numRanges );
+
+  std::vector<std::pair<std::size_t, std::size_t>> ranges;
+
+  for( std::size_t begin = 0; begin < count; begin += sizeOfRange ) {
+    ranges.emplace_back( begin, std::min( count, begin + sizeOfRange ) );
+  }
+
+  QtConcurrent::blockingMap( ranges, [&function]( const std::pair<std::size_t, std::size_t>& range ) {
+    function( range.first, range.second );
+  } );
+}
+
+void GeographicConvertionWrapper::Forward( const GeographicPosition* positions, LocalPosition* localPositions, std::size_t count,
+    bool withHeight, bool parallel ) {
+  if( count == 0 ) {
+    return;
+  }
+
+  // the same side effects as the single conversions
+  if( !isLatLonOffsetSet ) {
+    Reset( positions[0].latitude, positions[0].longitude, withHeight ? positions[0].height : height0TM );
+  }
+
+  if( withHeight && qIsNull( height0TM ) ) {
+    height0TM = positions[0].height;
+  }
+
+  // the points outside of the fitted square are converted exactly, as the anchor can't be moved while running in parallel
+  if( useFastProjection && withHeight ) {
+    if( !fastProjection.valid || fastProjection.useTM != useTM || fastProjection.height0TM != height0TM ) {
+      anchorFastProjection( positions[0].latitude, positions[0].longitude, positions[0].height );
+    }
+
+    forEachRange( count, parallel, [&]( std::size_t begin, std::size_t end ) {
+      for( std::size_t i = begin; i < end; ++i ) {
+        const auto& position = positions[i];
+        auto& localPosition = localPositions[i];
+
+        if( !forwardFast( position.latitude, position.longitude, position.height, localPosition.x, localPosition.y, localPosition.z ) ) {
+          forwardExact( position.latitude, position.longitude, position.height, localPosition.x, localPosition.y, localPosition.z );
+        }
+      }
+    } );
+  } else if( useTM ) {
+    const TransverseMercator& transverseMercator = TransverseMercator::UTM();
+
+    forEachRange( count, parallel, [&]( std::size_t begin, std::size_t end ) {
+      for( std::size_t i = begin; i < end; ++i ) {
+        double x, y;
+        transverseMercator.Forward( lon0TM, positions[i].latitude, positions[i].longitude, y, x );
+        localPositions[i].x = x - falseNorthingTM;
+        localPositions[i].y = -y;
+        localPositions[i].z = withHeight ? ( positions[i].height - height0TM ) : 0;
+      }
+    } );
+  } else {
+    const double heightOrigin = _lc.HeightOrigin();
+
+    forEachRange( count, parallel, [&]( std::size_t begin, std::size_t end ) {
+      for( std::size_t i = begin; i < end; ++i ) {
+        double x, y, z;
+        _lc.Forward( positions[i].latitude, positions[i].longitude, withHeight ? positions[i].height : heightOrigin, y, x, z );
+        localPositions[i].x = x;
+        localPositions[i].y = -y;
+        localPositions[i].z = z;
+      }
+    } );
+  }
+}
+
+void GeographicConvertionWrapper::Reverse( const LocalPosition* localPositions, GeographicPosition* positions, std::size_t count,
+    bool withHeight, bool parallel ) const {
+  if( !isLatLonOffsetSet ) {
+    std::fill( positions, positions + count, GeographicPosition{ 0, 0, 0 } );
+    return;
+  }
+
+  if( useTM ) {
+    const TransverseMercator& transverseMercator = TransverseMercator::UTM();
+
+    forEachRange( count, parallel, [&]( std::size_t begin, std::size_t end ) {
+      for( std::size_t i = begin; i < end; ++i ) {
+        transverseMercator.Reverse( lon0TM, -localPositions[i].y, localPositions[i].x + falseNorthingTM, positions[i].latitude, positions[i].longitude );
+        positions[i].height = withHeight ? ( localPositions[i].z + height0TM ) : height0TM;
+      }
+    } );
+  } else {
+    const double heightOrigin = _lc.HeightOrigin();
+
+    forEachRange( count, parallel, [&]( std::size_t begin, std::size_t end ) {
+      for( std::size_t i = begin; i < end; ++i ) {
+        _lc.Reverse( -localPositions[i].y, localPositions[i].x, withHeight ? localPositions[i].z : heightOrigin,
+                     positions[i].latitude, positions[i].longitude, positions[i].height );
+      }
+    } );
+  }
+}
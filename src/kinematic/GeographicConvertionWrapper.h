@@ -23,6 +23,8 @@
 #include <GeographicLib/UTMUPS.hpp>
 #include <GeographicLib/Ellipsoid.hpp>
 
+#include <cstddef>
+
 // NOTE: QtOpenGuidance uses the coordinate system for the vehicle according to ISO 8855:2011(E)
 // (Y left, X forward, Z up), but the coordinate system of the geographic conversions
 // is another one: X east, Y north and Z up. As this is the only code that uses both,
@@ -34,6 +36,19 @@ using namespace GeographicLib;
 
 // an instance of this class gets shared across all the blocks, so the conversions are the same everywhere
 class GeographicConvertionWrapper {
+  public:
+    struct GeographicPosition {
+      double latitude;
+      double longitude;
+      double height;
+    };
+
+    struct LocalPosition {
+      double x;
+      double y;
+      double z;
+    };
+
   public:
 
     GeographicConvertionWrapper() {
@@ -54,16 +69,14 @@ class GeographicConvertionWrapper {
         height0TM = height;
       }
 
-      if( useTM ) {
-        TransverseMercator::UTM().Forward( lon0TM, latitude, longitude, y, x );
-        x -= falseNorthingTM;
-        y = -y;
-        z = height - height0TM;
+      if( useFastProjection ) {
+        if( !forwardFast( latitude, longitude, height, x, y, z ) ) {
+          anchorFastProjection( latitude, longitude, height );
+          forwardFast( latitude, longitude, height, x, y, z );
+        }
       } else {
-        _lc.Forward( latitude, longitude,  height, y, x, z );
-        y = -y;
+        forwardExact( latitude, longitude, height, x, y, z );
       }
-
     }
 
     void Forward( const double latitude, const double longitude, double& x, double& y, double& z ) {
@@ -131,11 +144,90 @@ class GeographicConvertionWrapper {
       _lc.Reset( latitude, longitude, height );
 
       isLatLonOffsetSet = true;
+
+      fastProjection.valid = false;
+    }
+
+    // batch versions of Forward() and Reverse(): the projection is chosen once for all the points, and with
+    // parallel set, big batches are split across threads. Without height, they work like the overloads without it
+    void Forward( const GeographicPosition* positions, LocalPosition* localPositions, std::size_t count,
+                  bool withHeight = true, bool parallel = false );
+    void Reverse( const LocalPosition* localPositions, GeographicPosition* positions, std::size_t count,
+                  bool withHeight = true, bool parallel = false ) const;
+
+    bool isOriginSet() const {
+      return isLatLonOffsetSet;
+    }
+
+    // the position set by Reset(); the local coordinates are relative to it
+    void getOrigin( double& latitude, double& longitude, double& height ) const {
+      latitude = _lc.LatitudeOrigin();
+      longitude = _lc.LongitudeOrigin();
+      height = height0TM;
+    }
+
+    // the maximal deviation of the fast projection from the exact one in m, checked when it was anchored
+    double fastProjectionError() const {
+      return fastProjection.valid ? fastProjection.maxError : 0;
     }
 
   public:
     bool useTM = true;
 
+    // Forward() with height evaluates cubic polynomials instead of the projection. They are fitted
+    // around an anchor, which is moved to the current position as soon as it leaves the square of
+    // +/- fastProjectionHalfSize around the anchor. Inside of it, the error is below 0.1 mm (see
+    // fastProjectionError()). Reverse() and the overloads without height are always exact.
+    bool useFastProjection = false;
+
+    static constexpr double fastProjectionHalfSize = 2000;
+
+  private:
+    void forwardExact( const double latitude, const double longitude, const double height, double& x, double& y, double& z ) const {
+      if( useTM ) {
+        TransverseMercator::UTM().Forward( lon0TM, latitude, longitude, y, x );
+        x -= falseNorthingTM;
+        y = -y;
+        z = height - height0TM;
+      } else {
+        _lc.Forward( latitude, longitude,  height, y, x, z );
+        y = -y;
+      }
+    }
+
+    // returns false, if the position is outside of the fitted square or there is no valid fit
+    bool forwardFast( const double latitude, const double longitude, const double height, double& x, double& y, double& z ) const;
+    void anchorFastProjection( const double latitude, const double longitude, const double height );
+
+    struct FastProjection {
+      bool valid = false;
+
+      // the projection and the origin the polynomials are fitted for
+      bool useTM = true;
+      double height0TM = 0;
+
+      double latitude = 0;
+      double longitude = 0;
+      double height = 0;
+
+      // degrees per unit of the normalized coordinates s and t
+      double halfSizeLatitude = 0;
+      double halfSizeLongitude = 0;
+
+      // x, y and z at the height of the anchor: cubic in s and t with the coefficients of
+      // 1, s, t, s², st, t², s³, s²t, st², t³
+      double x[10] = {};
+      double y[10] = {};
+      double z[10] = {};
+
+      // derivatives by the height: linear in s and t
+      double dx[3] = {};
+      double dy[3] = {};
+      double dz[3] = {};
+
+      double maxError = 0;
+    } fastProjection;
+
   private:
     LocalCartesian _lc;
 
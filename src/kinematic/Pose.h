@@ -0,0 +1,78 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QMetaType>
+#include <QQuaternion>
+#include <QDateTime>
+
+#include <type_traits>
+
+#include "../kinematic/cgalKernel.h"
+#include "../kinematic/PoseOptions.h"
+
+// A pose is passed by value between the blocks. It is kept trivially copyable, so
+// queued connections over thread boundaries boil down to a memcpy of the whole struct
+class Pose {
+  public:
+    Pose() = default;
+
+    Pose( const Point_3& position,
+          const QQuaternion& orientation,
+          const PoseOption::Options options = PoseOption::NoOptions,
+          const qint64 timestamp = 0,
+          const quint32 sequenceNumber = 0 )
+      : position( position ),
+        orientation( orientation ),
+        options( options ),
+        sequenceNumber( sequenceNumber ),
+        timestamp( timestamp ) {}
+
+    // creates a new pose at the current time
+    static Pose now( const Point_3& position,
+                     const QQuaternion& orientation,
+                     const PoseOption::Options options,
+                     const quint32 sequenceNumber ) {
+      return Pose( position, orientation, options, QDateTime::currentMSecsSinceEpoch(), sequenceNumber );
+    }
+
+    // returns a pose derived from this one (another point on the same vehicle/implement), which
+    // keeps the timestamp and sequence number, so the receiver can match it to the original fix
+    Pose derive( const Point_3& position,
+                 const QQuaternion& orientation,
+                 const PoseOption::Options options ) const {
+      return Pose( position, orientation, options, timestamp, sequenceNumber );
+    }
+
+  public:
+    Point_3 position = Point_3( 0, 0, 0 );
+    QQuaternion orientation = QQuaternion();
+    PoseOption::Options options = PoseOption::NoOptions;
+
+    // incremented by the source of the pose for every fix
+    quint32 sequenceNumber = 0;
+
+    // in ms since the epoch
+    qint64 timestamp = 0;
+};
+
+static_assert( std::is_trivially_copyable<Pose>::value, "Pose has to be trivially copyable" );
+
+Q_DECLARE_TYPEINFO( Pose, Q_MOVABLE_TYPE );
+Q_DECLARE_METATYPE( Pose )
@@ -33,7 +33,7 @@
 #include "../block/BlockBase.h"
 
 #include "../kinematic/cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 
 class TrailerKinematic : public BlockBase {
     Q_OBJECT
@@ -58,8 +58,11 @@ class TrailerKinematic : public BlockBase {
       m_maxAngle = maxAngle;
     }
 
-    void setPose( const Point_3 position, const QQuaternion rotation, const PoseOption::Options options ) {
-      QQuaternion orientation = rotation;
+    void setPose( const Pose& pose ) {
+      const Point_3& position = pose.position;
+      const PoseOption::Options options = pose.options;
+
+      QQuaternion orientation = pose.orientation;
       QQuaternion orientationTrailer = QQuaternion();
 
       if( options.testFlag( PoseOption::CalculateWithoutOrientation ) ) {
@@ -106,23 +109,18 @@ class TrailerKinematic : public BlockBase {
                                           positionPivotPoint.y() + double( positionTowPointCorrection.y() ),
                                           positionPivotPoint.z() + double( positionTowPointCorrection.z() ) );
 
-      if( options.testFlag( PoseOption::CalculateFromPivotPoint ) ) {
-        PoseOption::Options flags = options;
-        flags.setFlag( PoseOption::CalculateFromPivotPoint, false );
-        emit poseHookPointChanged( position, orientation, flags );
-        emit posePivotPointChanged( positionPivotPoint, orientation, flags );
-        emit poseTowPointChanged( positionTowPoint, orientation, flags );
-      } else {
-        emit poseHookPointChanged( position, orientation, options );
-        emit posePivotPointChanged( positionPivotPoint, orientation, options );
-        emit poseTowPointChanged( positionTowPoint, orientation, options );
-      }
+      PoseOption::Options flags = options;
+      flags.setFlag( PoseOption::CalculateFromPivotPoint, false );
+
+      emit poseHookPointChanged( pose.derive( position, orientation, flags ) );
+      emit posePivotPointChanged( pose.derive( positionPivotPoint, orientation, flags ) );
+      emit poseTowPointChanged( pose.derive( positionTowPoint, orientation, flags ) );
     }
 
   signals:
-    void poseHookPointChanged( const Point_3, const QQuaternion, const PoseOption::Options );
-    void posePivotPointChanged( const Point_3, const QQuaternion, const PoseOption::Options );
-    void poseTowPointChanged( const Point_3, const QQuaternion, const PoseOption::Options );
+    void poseHookPointChanged( const Pose& );
+    void posePivotPointChanged( const Pose& );
+    void poseTowPointChanged( const Pose& );
 
   private:
     // defined in the normal way: x+ is forwards, so m_offsetTowPoint is a negative vector
@@ -153,11 +151,11 @@ class TrailerKinematicFactory : public BlockFactory {
       b->addInputPort( QStringLiteral( "OffsetTowPoint" ), QLatin1String( SLOT( setOffsetTowPointPosition( QVector3D ) ) ) );
       b->addInputPort( QStringLiteral( "MaxJackknifeAngle" ), QLatin1String( SLOT( setMaxJackknifeAngle( double ) ) ) );
       b->addInputPort( QStringLiteral( "MaxAngle" ), QLatin1String( SLOT( setMaxAngle( double ) ) ) );
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
 
-      b->addOutputPort( QStringLiteral( "Pose Hook Point" ), QLatin1String( SIGNAL( poseHookPointChanged( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
-      b->addOutputPort( QStringLiteral( "Pose Pivot Point" ), QLatin1String( SIGNAL( posePivotPointChanged( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
-      b->addOutputPort( QStringLiteral( "Pose Tow Point" ), QLatin1String( SIGNAL( poseTowPointChanged( const Point_3, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addOutputPort( QStringLiteral( "Pose Hook Point" ), QLatin1String( SIGNAL( poseHookPointChanged( const Pose& ) ) ) );
+      b->addOutputPort( QStringLiteral( "Pose Pivot Point" ), QLatin1String( SIGNAL( posePivotPointChanged( const Pose& ) ) ) );
+      b->addOutputPort( QStringLiteral( "Pose Tow Point" ), QLatin1String( SIGNAL( poseTowPointChanged( const Pose& ) ) ) );
 
       return b;
     }
@@ -31,6 +31,7 @@
 #include <fstream>
 #include <cassert>
 #include <stdint.h>
+#include <limits>
 
 typedef int32_t PassNumber;
 
@@ -104,8 +105,15 @@ typedef VD::Ccb_halfedge_circulator   VdCcb_halfedge_circulator;
 #include <CGAL/Alpha_shape_2.h>
 #include <CGAL/Alpha_shape_vertex_base_2.h>
 #include <CGAL/Alpha_shape_face_base_2.h>
+#include <CGAL/Triangulation_vertex_base_with_info_2.h>
+// the index of a vertex on the boundary, only used while the boundary is extracted; unset otherwise
+struct AlphaVertexIndex {
+  static constexpr uint32_t unset = std::numeric_limits<uint32_t>::max();
+  uint32_t index = unset;
+};
 typedef CGAL::Tag_true                                                            Alpha_cmp_tag;
-typedef CGAL::Alpha_shape_vertex_base_2<Epick, CGAL::Default, Alpha_cmp_tag>      AVb;
+typedef CGAL::Triangulation_vertex_base_with_info_2<AlphaVertexIndex, Epick>      AVbInfo;
+typedef CGAL::Alpha_shape_vertex_base_2<Epick, AVbInfo, Alpha_cmp_tag>            AVb;
 typedef CGAL::Alpha_shape_face_base_2<Epick, CGAL::Default, Alpha_cmp_tag>        AFb;
 typedef CGAL::Triangulation_data_structure_2<AVb, AFb>                            ATds;
 typedef CGAL::Delaunay_triangulation_2<Epick, ATds>                               ATriangulation_2;
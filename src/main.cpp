@@ -28,6 +28,7 @@
 #include <QSettings>
 #include <QStandardPaths>
 #include <QEvent>
+#include <QCommandLineParser>
 
 #include <Qt3DRender/QCamera>
 #include <Qt3DCore/QEntity>
@@ -76,10 +77,14 @@
 #include "gui/PassToolbar.h"
 #include "gui/FieldsToolbar.h"
 #include "gui/FieldsOptimitionToolbar.h"
+#include "gui/HeadlessRunner.h"
+
+#include "kinematic/FieldBenchmark.h"
 
 #include "block/CameraController.h"
 #include "block/FieldManager.h"
 #include "block/FpsMeasurement.h"
+#include "block/FrameTiming.h"
 #include "block/TractorModel.h"
 #include "block/TrailerModel.h"
 #include "block/GridModel.h"
@@ -94,6 +99,8 @@
 #include "block/PoseSynchroniser.h"
 
 #include "kinematic/FixedKinematic.h"
+#include "kinematic/Pose.h"
+
 #include "kinematic/TrailerKinematic.h"
 #include "kinematic/Plan.h"
 #include "kinematic/PlanGlobal.h"
@@ -128,10 +135,64 @@ int main( int argc, char** argv ) {
   // make qDebug() more expressive
 //  qSetMessagePattern( "%{file}:%{line}, %{function}: %{message}" );
 
+  // the headless mode doesn't need a display or a GPU, so use the offscreen platform. This has to be
+  // set before QApplication is constructed, so the arguments can't be parsed by QCommandLineParser yet
+  // QCommandLineParser also accepts the value after a "=", pe. "--headless=<file>"
+  const auto isOption = []( const char* argument, const char* option ) {
+    const auto length = qstrlen( option );
+    return qstrncmp( argument, option, length ) == 0 && ( argument[length] == '\0' || argument[length] == '=' );
+  };
+
+  for( int i = 1; i < argc; ++i ) {
+    if( isOption( argv[i], "--headless" ) || isOption( argv[i], "--benchmark-field" ) ) {
+      qputenv( "QT_QPA_PLATFORM", "offscreen" );
+    }
+  }
+
   QApplication app( argc, argv );
   QApplication::setOrganizationDomain( QStringLiteral( "QtOpenGuidance.org" ) );
   QApplication::setApplicationName( QStringLiteral( "QtOpenGuidance" ) );
 
+  qRegisterMetaType<Plan>();
+  qRegisterMetaType<PlanGlobal>();
+  qRegisterMetaType<Pose>();
+
+  QCommandLineParser parser;
+  parser.addHelpOption();
+  QCommandLineOption headlessOption( QStringLiteral( "headless" ),
+                                     QStringLiteral( "Run the config <file> without the 3D view and the docks, then exit." ),
+                                     QStringLiteral( "file" ) );
+  QCommandLineOption replayOption( QStringLiteral( "replay" ),
+                                   QStringLiteral( "In headless mode, feed <file> into all the file streams as fast as possible." ),
+                                   QStringLiteral( "file" ) );
+  QCommandLineOption compiledConnectionsOption( QStringLiteral( "compiled-connections" ),
+      QStringLiteral( "Call the slots of the blocks directly, ordered topologically, instead of over the signals of Qt." ) );
+  QCommandLineOption benchmarkConnectionsOption( QStringLiteral( "benchmark-connections" ),
+      QStringLiteral( "In headless mode, time the replay with signal and with compiled connections." ) );
+  QCommandLineOption benchmarkFieldOption( QStringLiteral( "benchmark-field" ),
+      QStringLiteral( "Time the calculation of the field boundary on synthetic points and the raw points of <file> (GeoJSON, can be empty), then exit." ),
+      QStringLiteral( "file" ) );
+  parser.addOption( headlessOption );
+  parser.addOption( replayOption );
+  parser.addOption( compiledConnectionsOption );
+  parser.addOption( benchmarkConnectionsOption );
+  parser.addOption( benchmarkFieldOption );
+  parser.process( app );
+
+  if( parser.isSet( benchmarkFieldOption ) ) {
+    FieldBenchmark fieldBenchmark;
+    return fieldBenchmark.run( parser.value( benchmarkFieldOption ) );
+  }
+
+  if( parser.isSet( compiledConnectionsOption ) ) {
+    QNEConnection::mode = QNEConnection::Mode::Compiled;
+  }
+
+  if( parser.isSet( headlessOption ) ) {
+    HeadlessRunner headlessRunner;
+    return headlessRunner.run( parser.value( headlessOption ), parser.value( replayOption ), parser.isSet( benchmarkConnectionsOption ) );
+  }
+
 #if !defined(Q_OS_LINUX) || defined(Q_OS_ANDROID)
   QIcon::setThemeSearchPaths( QIcon::themeSearchPaths() << QStringLiteral( ":themes/" ) );
   QIcon::setThemeName( QStringLiteral( "oxygen" ) );
@@ -159,9 +220,6 @@ int main( int argc, char** argv ) {
 
   qDebug() << "DPI: " << qApp->desktop()->logicalDpiX() << qApp->desktop()->logicalDpiY() << qApp->desktop()->devicePixelRatioF() << qApp->desktop()->widthMM() << qApp->desktop()->heightMM();
 
-  qRegisterMetaType<Plan>();
-  qRegisterMetaType<PlanGlobal>();
-
   QWidget* container = QWidget::createWindowContainer( view );
 //  QSize screenSize = view->screen()->size();
 //  container->setMinimumSize( QSize( 500, 400 ) );
@@ -418,9 +476,13 @@ int main( int argc, char** argv ) {
   auto* gridModel = qobject_cast<GridModel*>( gridModelBlock->object );
 
   // FPS measuremend block
-  BlockFactory* fpsMeasurementFactory = new FpsMeasurementFactory( rootEntity );
+  BlockFactory* fpsMeasurementFactory = new FpsMeasurementFactory( rootEntity, view );
   fpsMeasurementFactory->createBlock( settingDialog->getSceneOfConfigGraphicsView() );
 
+  // frame timing block
+  BlockFactory* frameTimingFactory = new FrameTimingFactory( rootEntity );
+  frameTimingFactory->createBlock( settingDialog->getSceneOfConfigGraphicsView() );
+
 
   // Setting Dialog
   QObject::connect( guidanceToolbar, &GuidanceToolbar::toggleSettings,
@@ -449,6 +511,8 @@ int main( int argc, char** argv ) {
                     gridModel, SLOT( setGrid( bool ) ) );
   QObject::connect( settingDialog, SIGNAL( setGridValues( float, float, float, float, float, float, float, QColor, QColor ) ),
                     gridModel, SLOT( setGridValues( float, float, float, float, float, float, float, QColor, QColor ) ) );
+  QObject::connect( settingDialog, SIGNAL( setGridProcedural( bool ) ),
+                    gridModel, SLOT( setGridProcedural( bool ) ) );
 
   // Simulator Docks
   QObject::connect( guidanceToolbar, &GuidanceToolbar::simulatorChanged,
@@ -503,12 +567,14 @@ int main( int argc, char** argv ) {
                     settingDialog->fieldManager, SLOT( recordPoint() ) );
   QObject::connect( fieldsToolbar, SIGNAL( recordOnEdgeOfImplementChanged( bool ) ),
                     settingDialog->fieldManager, SLOT( recordOnEdgeOfImplementChanged( bool ) ) );
-  QObject::connect( fieldsOptimitionToolbar, SIGNAL( recalculateFieldSettingsChanged( FieldsOptimitionToolbar::AlphaType, double, double, double ) ),
-                    settingDialog->fieldManager, SLOT( setRecalculateFieldSettings( FieldsOptimitionToolbar::AlphaType, double, double, double ) ) );
+  QObject::connect( fieldsOptimitionToolbar, SIGNAL( recalculateFieldSettingsChanged( FieldsOptimitionToolbar::AlphaType, double, double, double, double ) ),
+                    settingDialog->fieldManager, SLOT( setRecalculateFieldSettings( FieldsOptimitionToolbar::AlphaType, double, double, double, double ) ) );
   QObject::connect( fieldsOptimitionToolbar, SIGNAL( recalculateField() ),
                     settingDialog->fieldManager, SLOT( recalculateField() ) );
-  QObject::connect( settingDialog->fieldManager, SIGNAL( alphaChanged( double, double ) ),
-                    fieldsOptimitionToolbar, SLOT( setAlpha( double, double ) ) );
+  QObject::connect( settingDialog->fieldManager, SIGNAL( alphaChanged( double, double, bool ) ),
+                    fieldsOptimitionToolbar, SLOT( setAlpha( double, double, bool ) ) );
+  QObject::connect( settingDialog->fieldManager, SIGNAL( fieldOptimitionProgress( int ) ),
+                    fieldsOptimitionToolbar, SLOT( setProgress( int ) ) );
 
   // set the defaults for the simulator
   simulatorVelocity->setValue( 0 );
@@ -55,6 +55,8 @@
 int QNEBlock::m_nextSystemId = int( IdRange::SystemIdStart );
 int QNEBlock::m_nextUserId = int( IdRange::UserIdStart );
 
+QHash<const QGraphicsScene*, QHash<int, QNEBlock*>> QNEBlock::m_blocksById;
+
 QNEBlock::QNEBlock( QObject* object, int id, bool systemBlock, QGraphicsItem* parent )
   : QGraphicsPathItem( parent ),
     systemBlock( systemBlock ), width( 20 ), height( cornerRadius * 2 ), object( object ) {
@@ -94,6 +96,8 @@ QNEBlock::QNEBlock( QObject* object, int id, bool systemBlock, QGraphicsItem* pa
 }
 
 QNEBlock::~QNEBlock() {
+  unregisterFromScene( scene() );
+
   object->deleteLater();
 }
 
@@ -117,6 +121,15 @@ QNEPort* QNEBlock::addPort( const QString& name, QLatin1String signalSlotSignatu
 
   port->setPortFlags( flags );
 
+  // the first port with a given name wins
+  if( ( flags & ( QNEPort::NamePort | QNEPort::TypePort ) ) == 0 ) {
+    auto& ports = isOutput ? outputPorts : inputPorts;
+
+    if( !ports.contains( name ) ) {
+      ports.insert( name, port );
+    }
+  }
+
   height += port->getHeightOfLabelBoundingRect();
 
   resizeBlockWidth();
@@ -181,27 +194,45 @@ void QNEBlock::setName( const QString& name, bool setFromLabel ) {
 }
 
 QVariant QNEBlock::itemChange( GraphicsItemChange change, const QVariant& value ) {
+  if( change == QGraphicsItem::ItemSceneChange ) {
+    unregisterFromScene( scene() );
+  }
 
-  Q_UNUSED( change )
+  if( change == QGraphicsItem::ItemSceneHasChanged ) {
+    registerInScene( scene() );
+  }
 
   return value;
 }
 
-QNEPort* QNEBlock::getPortWithName( const QString& name, bool output ) {
-  const auto& constRefOfList = childItems();
+void QNEBlock::registerInScene( const QGraphicsScene* scene ) {
+  if( scene != nullptr ) {
+    m_blocksById[scene].insert( id, this );
+  }
+}
 
-  for( const auto& item : constRefOfList ) {
-    auto* port = qgraphicsitem_cast<QNEPort*>( item );
+void QNEBlock::unregisterFromScene( const QGraphicsScene* scene ) {
+  if( scene != nullptr ) {
+    auto blocksOfScene = m_blocksById.find( scene );
 
-    if( ( port != nullptr ) &&
-        ( ( port->portFlags() & ( QNEPort::NamePort | QNEPort::TypePort ) ) == 0 ) &&
-        port->isOutput() == output &&
-        port->getName() == name ) {
-      return port;
+    if( blocksOfScene != m_blocksById.end() ) {
+      if( blocksOfScene->value( id, nullptr ) == this ) {
+        blocksOfScene->remove( id );
+      }
+
+      if( blocksOfScene->isEmpty() ) {
+        m_blocksById.erase( blocksOfScene );
+      }
     }
   }
+}
+
+QNEPort* QNEBlock::getPortWithName( const QString& name, bool output ) {
+  if( output ) {
+    return outputPorts.value( name, nullptr );
+  }
 
-  return nullptr;
+  return inputPorts.value( name, nullptr );
 }
 
 void QNEBlock::toJSON( QJsonObject& json ) {
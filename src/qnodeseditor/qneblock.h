@@ -28,6 +28,7 @@
 #pragma once
 
 #include <QGraphicsPathItem>
+#include <QHash>
 
 class QNEPort;
 
@@ -66,6 +67,11 @@ class QNEBlock : public QGraphicsPathItem {
 
     QNEPort* getPortWithName( const QString& name, bool output );
 
+    // lookup of the blocks of a scene by id; the blocks register themselves when added to a scene
+    static QNEBlock* getBlockWithId( const QGraphicsScene* scene, int id ) {
+      return m_blocksById.value( scene ).value( id, nullptr );
+    }
+
     bool systemBlock = false;
 
   public:
@@ -91,6 +97,12 @@ class QNEBlock : public QGraphicsPathItem {
     static int m_nextSystemId;
     static int m_nextUserId;
 
+    // per scene, so another scene (pe. of the headless mode) has its own ids
+    static QHash<const QGraphicsScene*, QHash<int, QNEBlock*>> m_blocksById;
+
+    void registerInScene( const QGraphicsScene* scene );
+    void unregisterFromScene( const QGraphicsScene* scene );
+
   protected:
     QVariant itemChange( GraphicsItemChange change, const QVariant& value ) override;
     void mouseReleaseEvent( QGraphicsSceneMouseEvent* event ) override;
@@ -100,6 +112,10 @@ class QNEBlock : public QGraphicsPathItem {
     qreal height = 0;
     QString name;
 
+    // the names of the ports don't change after creation (except name/type ports, which are not in here)
+    QHash<QString, QNEPort*> inputPorts;
+    QHash<QString, QNEPort*> outputPorts;
+
   public:
     const QString getName() {
       return name;
@@ -29,6 +29,7 @@
 
 #include "qneport.h"
 #include "qneblock.h"
+#include "qnedispatcher.h"
 
 #include <QObject>
 #include <QBrush>
@@ -42,6 +43,8 @@
 #include <QJsonValue>
 #include <QJsonValueRef>
 
+QNEConnection::Mode QNEConnection::mode = QNEConnection::Mode::Signal;
+
 QNEConnection::QNEConnection( QGraphicsItem* parent ) : QGraphicsPathItem( parent ) {
   setPen( QPen( Qt::black, 2 ) );
   setBrush( Qt::NoBrush );
@@ -72,7 +75,7 @@ QNEConnection::~QNEConnection() {
     }
   }
 
-  QObject::disconnect( connection );
+  disconnectPorts();
 }
 
 
@@ -106,12 +109,7 @@ void QNEConnection::setPort1( QNEPort* p ) {
 }
 
 bool QNEConnection::setPort2( QNEPort* p ) {
-
-  connection = QObject::connect( m_port1->block()->object, ( const char* )( m_port1->slotSignalSignature.latin1() ),
-                                 p->block()->object, ( const char* )( p->slotSignalSignature.latin1() ),
-                                 Qt::ConnectionType( Qt::AutoConnection | Qt::UniqueConnection ) );
-
-  if( ( bool )connection ) {
+  if( connectPorts( p ) ) {
     m_port2 = p;
     m_port2->connections().push_back( this );
 
@@ -121,6 +119,78 @@ bool QNEConnection::setPort2( QNEPort* p ) {
   return false;
 }
 
+bool QNEConnection::reconnect() {
+  if( ( m_port1 == nullptr ) || ( m_port2 == nullptr ) ) {
+    return false;
+  }
+
+  disconnectPorts();
+
+  return connectPorts( m_port2 );
+}
+
+// the signature is in the form of the SIGNAL()/SLOT() macros: the first character is the code of the macro
+static int indexOfMethod( const QObject* object, QLatin1String signature ) {
+  if( signature.size() < 2 ) {
+    return -1;
+  }
+
+  const QByteArray normalizedSignature = QMetaObject::normalizedSignature( QByteArray( signature.data() + 1, signature.size() - 1 ).constData() );
+
+  return object->metaObject()->indexOfMethod( normalizedSignature.constData() );
+}
+
+bool QNEConnection::connectPorts( QNEPort* portTo ) {
+  QObject* sender = m_port1->block()->object;
+  QObject* receiver = portTo->block()->object;
+
+  if( mode == Mode::Compiled ) {
+    int signalIndex = indexOfMethod( sender, m_port1->slotSignalSignature );
+    int slotIndex = indexOfMethod( receiver, portTo->slotSignalSignature );
+
+    if( signalIndex != -1 && slotIndex != -1 && QNEDispatcher::canCall( sender, signalIndex, receiver, slotIndex ) ) {
+      // the same slot only once, as with Qt::UniqueConnection
+      for( const auto& otherConnection : m_port1->connections() ) {
+        if( otherConnection != this && otherConnection->dispatched && otherConnection->port2() != nullptr &&
+            otherConnection->port2()->block()->object == receiver &&
+            otherConnection->port2()->slotSignalSignature == portTo->slotSignalSignature ) {
+          return false;
+        }
+      }
+
+      if( m_port1->dispatcher == nullptr ) {
+        m_port1->dispatcher = new QNEDispatcher( sender, signalIndex );
+      }
+
+      m_port1->dispatcher->addCall( this, receiver, slotIndex );
+      dispatched = true;
+
+      return true;
+    }
+  }
+
+  connection = QObject::connect( sender, ( const char* )( m_port1->slotSignalSignature.latin1() ),
+                                 receiver, ( const char* )( portTo->slotSignalSignature.latin1() ),
+                                 Qt::ConnectionType( Qt::AutoConnection | Qt::UniqueConnection ) );
+
+  return ( bool )connection;
+}
+
+void QNEConnection::disconnectPorts() {
+  if( dispatched ) {
+    dispatched = false;
+    m_port1->dispatcher->removeCall( this );
+
+    if( m_port1->dispatcher->isEmpty() ) {
+      delete m_port1->dispatcher;
+      m_port1->dispatcher = nullptr;
+    }
+  }
+
+  QObject::disconnect( connection );
+  connection = QMetaObject::Connection();
+}
+
 void QNEConnection::updatePosFromPorts() {
   pos1 = m_port1->scenePos();
   pos2 = m_port2->scenePos();
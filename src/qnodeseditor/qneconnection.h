@@ -57,6 +57,27 @@ class QNEConnection : public QGraphicsPathItem {
 
     void toJSON( QJsonObject& json );
 
+    // connects the blocks again in the current mode; as the slots are called in the order of the connections,
+    // this is used to bring the connections of an output port in order
+    bool reconnect();
+
+  public:
+    // Signal: the ports are connected with their SIGNAL()/SLOT() signatures, every emit is dispatched by Qt
+    //         to every connected slot
+    // Compiled: the slots are resolved once and called directly by the QNEDispatcher of the output port, in
+    //           the topological order of the receiving blocks (see QNEGraph::compile()). Slots, which can't
+    //           be called directly (pe. of a block in another thread), are connected as with Signal
+    enum class Mode {
+      Signal,
+      Compiled
+    };
+
+    static Mode mode;
+
+  private:
+    bool connectPorts( QNEPort* portTo );
+    void disconnectPorts();
+
   private:
     QPointF pos1;
     QPointF pos2;
@@ -64,5 +85,7 @@ class QNEConnection : public QGraphicsPathItem {
     QNEPort* m_port2 = nullptr;
 
     QMetaObject::Connection connection;
+    // called by the dispatcher of m_port1 instead
+    bool dispatched = false;
 };
 
@@ -0,0 +1,98 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "qnedispatcher.h"
+
+#include <QMetaMethod>
+#include <QThread>
+
+#include <algorithm>
+
+namespace {
+  // the class of the meta object hierarchy, which declares the method
+  const QMetaObject* metaObjectOfMethod( const QMetaObject* metaObject, int methodIndex ) {
+    while( metaObject != nullptr && methodIndex < metaObject->methodOffset() ) {
+      metaObject = metaObject->superClass();
+    }
+
+    return metaObject;
+  }
+
+  // the first method of QNEDispatcher after the ones of QObject; it has no meta object of its own
+  const int indexOfDispatchSlot = QObject::staticMetaObject.methodCount();
+}
+
+QNEDispatcher::QNEDispatcher( QObject* sender, int signalIndex )
+  : QObject() {
+  signalConnection = QMetaObject::connect( sender, signalIndex, this, indexOfDispatchSlot, Qt::DirectConnection );
+}
+
+QNEDispatcher::~QNEDispatcher() {
+  QObject::disconnect( signalConnection );
+}
+
+bool QNEDispatcher::canCall( const QObject* sender, int signalIndex, const QObject* receiver, int slotIndex ) {
+  if( sender->thread() != receiver->thread() ) {
+    return false;
+  }
+
+  const QMetaMethod signal = sender->metaObject()->method( signalIndex );
+  const QMetaMethod slot = receiver->metaObject()->method( slotIndex );
+
+  if( signal.methodType() != QMetaMethod::Signal || !QMetaObject::checkConnectArgs( signal, slot ) ) {
+    return false;
+  }
+
+  const auto* metaObject = metaObjectOfMethod( receiver->metaObject(), slotIndex );
+
+  return metaObject != nullptr && metaObject->d.static_metacall != nullptr;
+}
+
+void QNEDispatcher::addCall( QNEConnection* connection, QObject* receiver, int slotIndex ) {
+  const auto* metaObject = metaObjectOfMethod( receiver->metaObject(), slotIndex );
+
+  calls.push_back( Call{ connection, receiver, metaObject->d.static_metacall, slotIndex - metaObject->methodOffset() } );
+}
+
+void QNEDispatcher::removeCall( QNEConnection* connection ) {
+  calls.erase( std::remove_if( calls.begin(), calls.end(), [connection]( const Call & call ) {
+    return call.connection == connection;
+  } ), calls.end() );
+}
+
+int QNEDispatcher::qt_metacall( QMetaObject::Call call, int id, void** arguments ) {
+  id = QObject::qt_metacall( call, id, arguments );
+
+  if( id < 0 ) {
+    return id;
+  }
+
+  if( call == QMetaObject::InvokeMetaMethod ) {
+    if( id == 0 ) {
+      // a slot can change the connections in the editor, so don't hold an iterator
+      for( std::size_t i = 0; i < calls.size(); ++i ) {
+        const Call slotCall = calls[i];
+        slotCall.function( slotCall.receiver, QMetaObject::InvokeMetaMethod, slotCall.index, arguments );
+      }
+    }
+
+    --id;
+  }
+
+  return id;
+}
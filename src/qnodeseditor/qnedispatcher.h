@@ -0,0 +1,64 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QObject>
+
+#include <vector>
+
+class QNEConnection;
+
+// the only receiver of the signal of an output port in QNEConnection::Mode::Compiled. The slots of the
+// connected blocks are resolved once into the static meta call of their class (the function moc generates
+// to call a slot with the arguments as void*), so an emit is dispatched by Qt only once to this object,
+// which then calls all the slots directly with the arguments of the signal, in the order they were added.
+// QObject::sender() is nullptr in the slots called this way.
+class QNEDispatcher : public QObject {
+  public:
+    QNEDispatcher( QObject* sender, int signalIndex );
+    ~QNEDispatcher();
+
+    // returns false, if the slot can't be called directly: signalIndex isn't a signal, the receiver lives
+    // in another thread, the arguments don't match or the class has no static meta call
+    static bool canCall( const QObject* sender, int signalIndex, const QObject* receiver, int slotIndex );
+
+    void addCall( QNEConnection* connection, QObject* receiver, int slotIndex );
+    void removeCall( QNEConnection* connection );
+
+    bool isEmpty() const {
+      return calls.empty();
+    }
+
+    // called by Qt for the signal; handwritten instead of moc, as the slot is only known at runtime
+    int qt_metacall( QMetaObject::Call call, int id, void** arguments ) override;
+
+  private:
+    using StaticMetacall = void ( * )( QObject*, QMetaObject::Call, int, void** );
+
+    struct Call {
+      QNEConnection* connection;
+      QObject* receiver;
+      StaticMetacall function;
+      // relative to the class the slot is declared in
+      int index;
+    };
+
+    std::vector<Call> calls;
+    QMetaObject::Connection signalConnection;
+};
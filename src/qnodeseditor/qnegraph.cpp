@@ -0,0 +1,200 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "qnegraph.h"
+
+#include <QGraphicsScene>
+#include <QHash>
+#include <QDebug>
+
+#include <algorithm>
+
+#include "qneblock.h"
+#include "qneport.h"
+#include "qneconnection.h"
+
+static QVector<QNEPort*> outputPortsOfBlock( QNEBlock* block ) {
+  QVector<QNEPort*> ports;
+
+  const auto& constRefOfList = block->childItems();
+
+  for( const auto& item : constRefOfList ) {
+    auto* port = qgraphicsitem_cast<QNEPort*>( item );
+
+    if( ( port != nullptr ) && port->isOutput() ) {
+      ports.push_back( port );
+    }
+  }
+
+  return ports;
+}
+
+QVector<QNEBlock*> QNEGraph::topologicalOrder( QGraphicsScene* scene ) {
+  QVector<QNEBlock*> blocks;
+
+  {
+    const auto& constRefOfList = scene->items();
+
+    for( const auto& item : constRefOfList ) {
+      auto* block = qgraphicsitem_cast<QNEBlock*>( item );
+
+      if( block != nullptr ) {
+        blocks.push_back( block );
+      }
+    }
+  }
+
+  // the order of the items of the scene depends on their position, so sort them by id to get a stable result
+  std::sort( blocks.begin(), blocks.end(), []( const QNEBlock * lhs, const QNEBlock * rhs ) {
+    return lhs->id < rhs->id;
+  } );
+
+  QHash<QNEBlock*, int> inDegree;
+  inDegree.reserve( blocks.size() );
+
+  for( const auto& block : qAsConst( blocks ) ) {
+    inDegree.insert( block, 0 );
+  }
+
+  for( const auto& block : qAsConst( blocks ) ) {
+    const auto ports = outputPortsOfBlock( block );
+
+    for( const auto& port : ports ) {
+      for( const auto& connection : port->connections() ) {
+        if( connection->port2() != nullptr ) {
+          ++inDegree[connection->port2()->block()];
+        }
+      }
+    }
+  }
+
+  // Kahn's algorithm
+  QVector<QNEBlock*> order;
+  order.reserve( blocks.size() );
+
+  for( const auto& block : qAsConst( blocks ) ) {
+    if( inDegree.value( block ) == 0 ) {
+      order.push_back( block );
+    }
+  }
+
+  for( int i = 0; i < order.size(); ++i ) {
+    const auto ports = outputPortsOfBlock( order.at( i ) );
+
+    for( const auto& port : ports ) {
+      for( const auto& connection : port->connections() ) {
+        if( connection->port2() != nullptr ) {
+          auto* receiver = connection->port2()->block();
+
+          if( --inDegree[receiver] == 0 ) {
+            order.push_back( receiver );
+          }
+        }
+      }
+    }
+  }
+
+  // cycles
+  if( order.size() != blocks.size() ) {
+    for( const auto& block : qAsConst( blocks ) ) {
+      if( inDegree.value( block ) > 0 ) {
+        order.push_back( block );
+      }
+    }
+  }
+
+  return order;
+}
+
+// connects the connections of the port again, in the order of the rank of the receiving blocks
+static void reconnectInOrder( QNEPort* port, const QHash<const QNEBlock*, int>& rank ) {
+  std::vector<QNEConnection*> connections;
+  connections.reserve( port->connections().size() );
+
+  for( const auto& connection : port->connections() ) {
+    if( connection->port2() != nullptr ) {
+      connections.push_back( connection );
+    }
+  }
+
+  std::stable_sort( connections.begin(), connections.end(), [&rank]( const QNEConnection * lhs, const QNEConnection * rhs ) {
+    return rank.value( lhs->port2()->block() ) < rank.value( rhs->port2()->block() );
+  } );
+
+  // the slots are called in the order of the connections, so connect them again in the sorted order
+  for( const auto& connection : connections ) {
+    if( !connection->reconnect() ) {
+      qWarning() << "QNEGraph::compile: couldn't reconnect" << port->getName() << "of" << port->block()->getName();
+    }
+  }
+}
+
+static QHash<const QNEBlock*, int> rankOfBlocks( const QVector<QNEBlock*>& order ) {
+  QHash<const QNEBlock*, int> rank;
+  rank.reserve( order.size() );
+
+  for( int i = 0; i < order.size(); ++i ) {
+    rank.insert( order.at( i ), i );
+  }
+
+  return rank;
+}
+
+void QNEGraph::compile( QGraphicsScene* scene ) {
+  if( QNEConnection::mode != QNEConnection::Mode::Compiled ) {
+    return;
+  }
+
+  const auto order = topologicalOrder( scene );
+  const auto rank = rankOfBlocks( order );
+
+  for( const auto& block : order ) {
+    const auto ports = outputPortsOfBlock( block );
+
+    for( const auto& port : ports ) {
+      reconnectInOrder( port, rank );
+    }
+  }
+}
+
+void QNEGraph::compile( QNEPort* port ) {
+  if( QNEConnection::mode != QNEConnection::Mode::Compiled || port == nullptr || port->scene() == nullptr ) {
+    return;
+  }
+
+  // the order of the whole graph is needed for the ranks, but only the connections of this port are made again
+  reconnectInOrder( port, rankOfBlocks( topologicalOrder( port->scene() ) ) );
+}
+
+void QNEGraph::setMode( QGraphicsScene* scene, QNEConnection::Mode mode ) {
+  QNEConnection::mode = mode;
+
+  if( mode == QNEConnection::Mode::Compiled ) {
+    compile( scene );
+  } else {
+    const auto& constRefOfList = scene->items();
+
+    for( const auto& item : constRefOfList ) {
+      auto* connection = qgraphicsitem_cast<QNEConnection*>( item );
+
+      if( connection != nullptr && connection->port2() != nullptr && !connection->reconnect() ) {
+        qWarning() << "QNEGraph::setMode: couldn't reconnect" << connection->port1()->getName() << "of" << connection->port1()->block()->getName();
+      }
+    }
+  }
+}
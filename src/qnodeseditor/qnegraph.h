@@ -0,0 +1,47 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QVector>
+
+#include "qneconnection.h"
+
+class QGraphicsScene;
+class QNEBlock;
+class QNEPort;
+
+// the graph of the blocks, as it is built up in the editor
+class QNEGraph {
+  public:
+    // returns the blocks of the scene in topological order: every block comes after all the blocks
+    // connected to its inputs. Blocks in a cycle are appended at the end, ordered by their id
+    static QVector<QNEBlock*> topologicalOrder( QGraphicsScene* scene );
+
+    // in QNEConnection::Mode::Compiled, builds the schedule of every output port: the slots it calls
+    // directly, ordered by the topological order of the receiving blocks. A pose then reaches all the
+    // blocks fed directly by a source before the ones further downstream. Does nothing in
+    // QNEConnection::Mode::Signal
+    static void compile( QGraphicsScene* scene );
+
+    // the same, but only for the connections of an output port, pe. after a connection is added in the editor
+    static void compile( QNEPort* port );
+
+    // switches all the connections of the scene to the mode, pe. to compare them
+    static void setMode( QGraphicsScene* scene, QNEConnection::Mode mode );
+};
@@ -27,6 +27,7 @@
 
 #include "qneport.h"
 #include "qneblock.h"
+#include "qnedispatcher.h"
 
 #include <QGraphicsScene>
 #include <QFontMetrics>
@@ -69,6 +70,9 @@ QNEPort::~QNEPort() {
     delete m_connections.back();
   }
 
+  // deleted by the last connection of it, but a dispatcher mustn't outlive the port
+  delete dispatcher;
+
   label->deleteLater();
 
   if( porthelper != nullptr ) {
@@ -38,6 +38,7 @@ class QNEBlock;
 class QNEConnection;
 
 class QNEPortHelper;
+class QNEDispatcher;
 
 class QNEPort : public QGraphicsPathItem {
   public:
@@ -84,6 +85,9 @@ class QNEPort : public QGraphicsPathItem {
 
     QGraphicsTextItem* label = nullptr;
 
+    // of an output in QNEConnection::Mode::Compiled; created and deleted by the connections
+    QNEDispatcher* dispatcher = nullptr;
+
   protected:
     QVariant itemChange( GraphicsItemChange change, const QVariant& value ) override;
 
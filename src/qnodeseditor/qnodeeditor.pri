@@ -7,6 +7,8 @@ SOURCES += \
     $$PWD/qneblock.cpp \
     $$PWD/qneport.cpp \
     $$PWD/qneconnection.cpp \
+    $$PWD/qnegraph.cpp \
+    $$PWD/qnedispatcher.cpp \
     $$PWD/qnodeseditor.cpp
 
 HEADERS += \
@@ -15,6 +17,8 @@ HEADERS += \
     $$PWD/qnegraphicsview.h \
     $$PWD/qneport.h \
     $$PWD/qneconnection.h \
+    $$PWD/qnegraph.h \
+    $$PWD/qnedispatcher.h \
     $$PWD/qnodeseditor.h
 
 SOURCES += \
@@ -41,6 +41,7 @@
 #include "qneport.h"
 #include "qneconnection.h"
 #include "qneblock.h"
+#include "qnegraph.h"
 #include "qnegestures.h"
 
 #include "../gui/SettingsDialog.h"
@@ -205,6 +206,8 @@ bool QNodesEditor::eventFilter( QObject* o, QEvent* e ) {
               currentConnection->updatePath();
               auto* block = qobject_cast<BlockBase*> ( currentConnection->port1()->block()->object );
 
+              QNEGraph::compile( currentConnection->port1() );
+
               if( block != nullptr ) {
                 block->emitConfigSignals();
               }
@@ -221,6 +224,8 @@ bool QNodesEditor::eventFilter( QObject* o, QEvent* e ) {
               currentConnection->updatePath();
               auto* block = qobject_cast<BlockBase*> ( currentConnection->port1()->block()->object );
 
+              QNEGraph::compile( currentConnection->port1() );
+
               if( block != nullptr ) {
                 block->emitConfigSignals();
               }